@@ -2,56 +2,278 @@
 #include <list>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 using namespace std;
 
+// Hashing
+// fmix64 is the murmur3 / xxh3-style avalanche finalizer: every input bit
+// flips each output bit with probability ~1/2, so keys that differ only in
+// high bits (or are negative) still spread over all buckets.
+inline uint64_t fmix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// 64x64 -> 128 bit multiply, folded (wyhash "mum")
+inline uint64_t mum(uint64_t a, uint64_t b) {
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+// wyhash-style byte hash: 16 bytes per multiply
+inline uint64_t hashBytes(const void* data, size_t len, uint64_t seed = 0) {
+    const uint64_t P0 = 0xa0761d6478bd642fULL, P1 = 0xe7037ed1a0b428dbULL;
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = seed ^ P0;
+    size_t n = len;
+    while (n >= 16) {
+        uint64_t a, b;
+        memcpy(&a, p, 8);
+        memcpy(&b, p + 8, 8);
+        h = mum(a ^ P1, b ^ h);
+        p += 16;
+        n -= 16;
+    }
+    uint64_t a = 0, b = 0;
+    if (n >= 8) {
+        memcpy(&a, p, 8);
+        memcpy(&b, p + 8, n - 8);
+    } else {
+        memcpy(&a, p, n);
+    }
+    return fmix64(mum(a ^ P1, b ^ h) ^ len);
+}
+
+// Default hasher: avalanche-mixed, never the raw key
+template<typename K, typename = void>
+struct DefaultHash {
+    size_t operator()(const K& key) const { return (size_t)fmix64(hash<K>{}(key)); }
+};
+
+template<typename K>
+struct DefaultHash<K, enable_if_t<is_integral<K>::value || is_enum<K>::value>> {
+    size_t operator()(K key) const { return (size_t)fmix64((uint64_t)key); }
+};
+
+// Transparent: string, string_view and const char* hash identically, so a
+// table keyed by string can be queried with a string_view without a copy
+template<>
+struct DefaultHash<string> {
+    using is_transparent = void;
+    size_t operator()(string_view s) const { return (size_t)hashBytes(s.data(), s.size()); }
+};
+
+template<>
+struct DefaultHash<string_view> : DefaultHash<string> {};
+
+// The textbook "key % capacity" hash, kept for comparison only
+struct IdentityHash {
+    size_t operator()(int key) const { return (size_t)key; }
+};
+
+// Heterogeneous lookup is enabled when both Hash and Eq are transparent;
+// otherwise the lookup key is converted to K first
+template<typename Hash, typename Eq, typename = void>
+struct IsTransparent : false_type {};
+
+template<typename Hash, typename Eq>
+struct IsTransparent<Hash, Eq, void_t<typename Hash::is_transparent, typename Eq::is_transparent>>
+    : true_type {};
+
+template<typename K, typename Hash, typename Eq, typename Q>
+decltype(auto) lookupKey(const Q& key) {
+    if constexpr (IsTransparent<Hash, Eq>::value || is_same<Q, K>::value) {
+        return (key);
+    } else {
+        K k = key;
+        return k;
+    }
+}
+
+// How HashTable grows once count exceeds capacity * maxLoad
+enum class RehashMode {
+    StopTheWorld,  // Move every entry to the doubled array in one O(n) pause
+    Incremental    // Keep both arrays; each insert/remove migrates a few buckets
+};
+
 // Hash Table with Chaining
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename Eq = equal_to<>,
+         typename Alloc = allocator<pair<const K, V>>>
 class HashTable {
 private:
-    int capacity;
-    list<pair<int, int>>* table;  // key-value pairs
+    using Chain = list<pair<const K, V>, Alloc>;
+    using ChainAlloc = typename allocator_traits<Alloc>::template rebind_alloc<Chain>;
+    using ChainTraits = allocator_traits<ChainAlloc>;
+
+    size_t capacity;
+    Chain* table;  // key-value pairs
     int count;
+    float maxLoad;
+    RehashMode mode;
+    size_t bucketsPerStep;
+    Hash hasher;
+    Eq eq;
+    Alloc alloc;
+    ChainAlloc chainAlloc;
+
+    // Incremental rehash state: buckets [0, rehashIndex) of oldTable are
+    // already moved into table, the rest still hold their entries. Since
+    // h % (2c) is h % c or h % c + c, old bucket j feeds only new buckets j
+    // and j + c, so those two are constructed when j migrates and the rest
+    // of the new array stays untouched memory (no O(n) initialization pause).
+    Chain* oldTable = nullptr;
+    size_t oldCapacity = 0;
+    size_t rehashIndex = 0;
+    bool rehashing = false;
 
-    int hash(int key) {
-        return key % capacity;
+    void constructBucket(Chain* bucket) { ChainTraits::construct(chainAlloc, bucket, alloc); }
+    void destroyBucket(Chain* bucket) { ChainTraits::destroy(chainAlloc, bucket); }
+
+    bool isLive(size_t i) const { return !rehashing || i % oldCapacity < rehashIndex; }
+
+    // Chain that holds (or would hold) key
+    template<typename Q>
+    const Chain& chainFor(const Q& key) const {
+        size_t h = hasher(key);
+        if (rehashing && h % oldCapacity >= rehashIndex) return oldTable[h % oldCapacity];
+        return table[h % capacity];
+    }
+
+    template<typename Q>
+    Chain& chainFor(const Q& key) {
+        return const_cast<Chain&>(as_const(*this).chainFor(key));
+    }
+
+    template<typename Q>
+    const pair<const K, V>* findEntry(const Q& key) const {
+        for (auto& p : chainFor(key)) {
+            if (eq(p.first, key)) return &p;
+        }
+        return nullptr;
+    }
+
+    // Move up to maxBuckets old buckets into table; splice relinks the
+    // existing nodes, so migration never allocates
+    void migrate(size_t maxBuckets) {
+        for (size_t n = 0; n < maxBuckets && rehashIndex < oldCapacity; n++, rehashIndex++) {
+            Chain& from = oldTable[rehashIndex];
+            constructBucket(table + rehashIndex);
+            constructBucket(table + rehashIndex + oldCapacity);
+            while (!from.empty()) {
+                Chain& to = table[hasher(from.front().first) % capacity];
+                to.splice(to.end(), from, from.begin());
+            }
+            destroyBucket(&from);
+        }
+        if (rehashIndex == oldCapacity) {
+            // One call returns the whole old array; with a large array this
+            // is the longest single step of the round (see the .md)
+            ChainTraits::deallocate(chainAlloc, oldTable, oldCapacity);
+            oldTable = nullptr;
+            rehashing = false;
+        }
+    }
+
+    void grow() {
+        // bucketsPerStep >= 2 / maxLoad finishes a round within the inserts
+        // that lead to the next growth, so this catch-up is only a safety net
+        if (rehashing) migrate(oldCapacity);
+        oldTable = table;
+        oldCapacity = capacity;
+        capacity *= 2;
+        table = ChainTraits::allocate(chainAlloc, capacity);
+        rehashIndex = 0;
+        rehashing = true;
+        if (mode == RehashMode::StopTheWorld) migrate(oldCapacity);
     }
 
 public:
-    HashTable(int cap = 10) {
-        capacity = cap;
-        table = new list<pair<int, int>>[capacity];
-        count = 0;
+    HashTable(size_t cap = 10, float maxLoadFactor = 1.0f, RehashMode rehashMode = RehashMode::StopTheWorld,
+              size_t stepBuckets = 8, const Hash& h = Hash(), const Eq& e = Eq(),
+              const Alloc& a = Alloc())
+        : capacity(max<size_t>(cap, 1)), count(0), maxLoad(min(max(0.125f, maxLoadFactor), 8.0f)), mode(rehashMode),
+          bucketsPerStep(max<size_t>(stepBuckets, (size_t)(2 / maxLoad))), hasher(h), eq(e), alloc(a), chainAlloc(a) {
+        table = ChainTraits::allocate(chainAlloc, capacity);
+        for (size_t i = 0; i < capacity; i++) constructBucket(table + i);
+    }
+
+    ~HashTable() {
+        for (size_t i = 0; i < capacity; i++) {
+            if (isLive(i)) destroyBucket(table + i);
+        }
+        ChainTraits::deallocate(chainAlloc, table, capacity);
+        if (rehashing) {
+            for (size_t i = rehashIndex; i < oldCapacity; i++) destroyBucket(oldTable + i);
+            ChainTraits::deallocate(chainAlloc, oldTable, oldCapacity);
+        }
     }
 
-    ~HashTable() { delete[] table; }
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
 
-    // Insert - O(1) average
-    void insert(int key, int value) {
-        int index = hash(key);
-        for (auto& p : table[index]) {
-            if (p.first == key) {
+    // Insert - O(1) average; incremental mode bounds the work to
+    // bucketsPerStep bucket moves plus the old array's deallocation at the
+    // end of a round (StopTheWorld: O(n) on growth)
+    void insert(const K& key, const V& value) {
+        if (rehashing) migrate(bucketsPerStep);
+        Chain& chain = chainFor(key);
+        for (auto& p : chain) {
+            if (eq(p.first, key)) {
                 p.second = value;  // Update existing
                 return;
             }
         }
-        table[index].push_back({key, value});
+        chain.emplace_back(key, value);
         count++;
+        if (count > capacity * maxLoad) grow();
+    }
+
+    // Search - O(1) average, nullptr if not found
+    template<typename Q>
+    V* find(const Q& key) {
+        return const_cast<V*>(as_const(*this).find(key));
+    }
+
+    template<typename Q>
+    const V* find(const Q& key) const {
+        auto* p = findEntry(lookupKey<K, Hash, Eq>(key));
+        return p ? &p->second : nullptr;
     }
 
     // Search - O(1) average
-    int get(int key) {
-        int index = hash(key);
-        for (auto& p : table[index]) {
-            if (p.first == key) return p.second;
-        }
-        return -1;  // Not found
+    template<typename Q>
+    V get(const Q& key, const V& notFound = V()) const {
+        const V* v = find(key);
+        return v ? *v : notFound;
     }
 
     // Delete - O(1) average
-    void remove(int key) {
-        int index = hash(key);
-        for (auto it = table[index].begin(); it != table[index].end(); it++) {
-            if (it->first == key) {
-                table[index].erase(it);
+    template<typename Q>
+    void remove(const Q& key) {
+        if (rehashing) migrate(bucketsPerStep);
+        const auto& k = lookupKey<K, Hash, Eq>(key);
+        Chain& chain = chainFor(k);
+        for (auto it = chain.begin(); it != chain.end(); it++) {
+            if (eq(it->first, k)) {
+                chain.erase(it);
                 count--;
                 return;
             }
@@ -59,78 +281,770 @@ public:
     }
 
     // Contains - O(1) average
-    bool contains(int key) {
-        int index = hash(key);
-        for (auto& p : table[index]) {
-            if (p.first == key) return true;
+    template<typename Q>
+    bool contains(const Q& key) const { return find(key) != nullptr; }
+
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    size_t bucketCount() const { return capacity; }
+    bool isRehashing() const { return rehashing; }
+
+    // histogram[len] = number of buckets whose chain has len entries
+    vector<size_t> chainLengthHistogram() const {
+        vector<size_t> histogram;
+        auto add = [&](const Chain& chain) {
+            if (chain.size() >= histogram.size()) histogram.resize(chain.size() + 1);
+            histogram[chain.size()]++;
+        };
+        for (size_t i = 0; i < capacity; i++) {
+            if (isLive(i)) add(table[i]);
         }
-        return false;
+        for (size_t i = rehashIndex; rehashing && i < oldCapacity; i++) add(oldTable[i]);
+        return histogram;
     }
 
-    int size() { return count; }
-    bool isEmpty() { return count == 0; }
-
-    void print() {
-        for (int i = 0; i < capacity; i++) {
+    void print() const {
+        for (size_t i = 0; i < capacity; i++) {
+            if (!isLive(i)) continue;
             cout << i << ": ";
             for (auto& p : table[i]) {
                 cout << "[" << p.first << "," << p.second << "] ";
             }
             cout << endl;
         }
+        for (size_t i = rehashIndex; rehashing && i < oldCapacity; i++) {
+            cout << "old " << i << ": ";
+            for (auto& p : oldTable[i]) {
+                cout << "[" << p.first << "," << p.second << "] ";
+            }
+            cout << endl;
+        }
     }
 };
 
 // HashSet
+template<typename K, typename Hash = DefaultHash<K>, typename Eq = equal_to<>,
+         typename Alloc = allocator<K>>
 class HashSet {
 private:
-    int capacity;
-    list<int>* table;
+    using Chain = list<K, Alloc>;
+    using ChainAlloc = typename allocator_traits<Alloc>::template rebind_alloc<Chain>;
+
+    size_t capacity;
+    vector<Chain, ChainAlloc> table;
     int count;
+    Hash hasher;
+    Eq eq;
 
-    int hash(int key) { return key % capacity; }
+    template<typename Q>
+    size_t index(const Q& key) const { return hasher(key) % capacity; }
 
 public:
-    HashSet(int cap = 10) {
+    HashSet(size_t cap = 10, const Hash& h = Hash(), const Eq& e = Eq(), const Alloc& alloc = Alloc())
+        : capacity(cap), table(cap, Chain(alloc), ChainAlloc(alloc)), count(0), hasher(h), eq(e) {}
+
+    void add(const K& key) {
+        if (contains(key)) return;
+        table[index(key)].push_back(key);
+        count++;
+    }
+
+    template<typename Q>
+    void remove(const Q& key) {
+        const auto& k = lookupKey<K, Hash, Eq>(key);
+        Chain& chain = table[index(k)];
+        for (auto it = chain.begin(); it != chain.end(); it++) {
+            if (eq(*it, k)) {
+                chain.erase(it);
+                count--;
+                return;
+            }
+        }
+    }
+
+    template<typename Q>
+    bool contains(const Q& key) const {
+        const auto& k = lookupKey<K, Hash, Eq>(key);
+        for (auto& val : table[index(k)]) {
+            if (eq(val, k)) return true;
+        }
+        return false;
+    }
+
+    int size() const { return count; }
+};
+
+// Flat Hash Table (Swiss-table style open addressing)
+// One control byte per slot: EMPTY, DELETED, or the low 7 bits of the hash
+// (h2) for a full slot. A lookup compares h2 against 16 control bytes at once
+// (one SSE2 instruction) and only touches slots whose tag matched, so a probe
+// usually reads one control group and one slot. Hash must be well mixed
+// (DefaultHash is): h1 takes the high bits, h2 the low 7.
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename Eq = equal_to<>,
+         typename Alloc = allocator<pair<K, V>>>
+class FlatHashTable {
+private:
+    using Slot = pair<K, V>;
+    using SlotAlloc = typename allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using SlotTraits = allocator_traits<SlotAlloc>;
+
+    static const int GROUP = 16;
+    static const int8_t EMPTY = -128;   // 0b10000000
+    static const int8_t DELETED = -2;   // 0b11111110
+
+    int8_t* ctrl;       // capacity + GROUP bytes, tail mirrors the head
+    Slot* slots;        // raw storage, constructed only where ctrl is full
+    size_t capacity;    // power of two, >= GROUP
+    size_t count;
+    size_t tombstones;
+    float maxLoad;
+    Hash hasher;
+    Eq eq;
+    SlotAlloc alloc;
+
+    static size_t h1(size_t h) { return h >> 7; }
+    static int8_t h2(size_t h) { return (int8_t)(h & 0x7F); }
+
+    // Bitmask of the bytes in the group at pos equal to tag
+    uint32_t match(size_t pos, int8_t tag) const {
+#ifdef __SSE2__
+        __m128i g = _mm_loadu_si128((const __m128i*)(ctrl + pos));
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(tag)));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < GROUP; i++) {
+            if (ctrl[pos + i] == tag) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Bitmask of EMPTY or DELETED bytes (both have the sign bit set)
+    uint32_t matchFree(size_t pos) const {
+#ifdef __SSE2__
+        __m128i g = _mm_loadu_si128((const __m128i*)(ctrl + pos));
+        return (uint32_t)_mm_movemask_epi8(g);
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < GROUP; i++) {
+            if (ctrl[pos + i] < 0) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    static int lowestBit(uint32_t mask) { return __builtin_ctz(mask); }
+
+    void setCtrl(size_t i, int8_t tag) {
+        ctrl[i] = tag;
+        if (i < GROUP) ctrl[capacity + i] = tag;  // Keep the mirrored tail in sync
+    }
+
+    // Slot index of key (whose hash is h), or capacity if absent
+    template<typename Q>
+    size_t findSlot(const Q& key) const { return findSlot(key, hasher(key)); }
+
+    template<typename Q>
+    size_t findSlot(const Q& key, size_t h) const {
+        size_t mask = capacity - 1;
+        size_t pos = h1(h) & mask;
+        for (size_t step = GROUP;; step += GROUP) {
+            for (uint32_t m = match(pos, h2(h)); m; m &= m - 1) {
+                size_t i = (pos + lowestBit(m)) & mask;
+                if (eq(slots[i].first, key)) return i;
+            }
+            if (match(pos, EMPTY)) return capacity;
+            pos = (pos + step) & mask;  // Triangular probing visits every group
+        }
+    }
+
+    // First EMPTY or DELETED slot on the probe sequence of hash h
+    size_t findFree(size_t h) const {
+        size_t mask = capacity - 1;
+        size_t pos = h1(h) & mask;
+        for (size_t step = GROUP;; step += GROUP) {
+            uint32_t m = matchFree(pos);
+            if (m) return (pos + lowestBit(m)) & mask;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    void allocate(size_t cap) {
         capacity = cap;
-        table = new list<int>[capacity];
+        ctrl = new int8_t[capacity + GROUP];
+        memset(ctrl, EMPTY, capacity + GROUP);
+        slots = SlotTraits::allocate(alloc, capacity);
         count = 0;
+        tombstones = 0;
     }
 
-    void add(int key) {
-        if (contains(key)) return;
-        int index = hash(key);
-        table[index].push_back(key);
+    void release(int8_t* oldCtrl, Slot* oldSlots, size_t oldCap) {
+        for (size_t i = 0; i < oldCap; i++) {
+            if (oldCtrl[i] >= 0) SlotTraits::destroy(alloc, oldSlots + i);
+        }
+        SlotTraits::deallocate(alloc, oldSlots, oldCap);
+        delete[] oldCtrl;
+    }
+
+    // Rebuild into newCap slots, dropping tombstones - O(n)
+    void rehash(size_t newCap) {
+        int8_t* oldCtrl = ctrl;
+        Slot* oldSlots = slots;
+        size_t oldCap = capacity;
+
+        allocate(newCap);
+        for (size_t i = 0; i < oldCap; i++) {
+            if (oldCtrl[i] >= 0) {
+                size_t h = hasher(oldSlots[i].first);
+                size_t j = findFree(h);
+                setCtrl(j, h2(h));
+                SlotTraits::construct(alloc, slots + j, move(oldSlots[i]));
+                count++;
+            }
+        }
+        release(oldCtrl, oldSlots, oldCap);
+    }
+
+public:
+    FlatHashTable(size_t cap = 16, float maxLoadFactor = 0.875f, const Hash& h = Hash(),
+                  const Eq& e = Eq(), const Alloc& a = Alloc())
+        : hasher(h), eq(e), alloc(a) {
+        maxLoad = min(max(maxLoadFactor, 0.25f), 0.9375f);
+        size_t c = GROUP;
+        while (c * maxLoad < cap) c <<= 1;
+        allocate(c);
+    }
+
+    ~FlatHashTable() { release(ctrl, slots, capacity); }
+
+    FlatHashTable(const FlatHashTable&) = delete;
+    FlatHashTable& operator=(const FlatHashTable&) = delete;
+
+    // Insert - O(1) average, amortized over growth
+    void insert(const K& key, const V& value) {
+        size_t h = hasher(key);
+        size_t i = findSlot(key, h);
+        if (i != capacity) {
+            slots[i].second = value;  // Update existing
+            return;
+        }
+        if (count + tombstones + 1 > capacity * maxLoad) {
+            // Grow if mostly live entries, otherwise just purge tombstones
+            rehash(count + 1 > capacity * maxLoad / 2 ? capacity * 2 : capacity);
+        }
+        size_t j = findFree(h);
+        if (ctrl[j] == DELETED) tombstones--;
+        setCtrl(j, h2(h));
+        SlotTraits::construct(alloc, slots + j, key, value);
         count++;
     }
 
-    void remove(int key) {
-        int index = hash(key);
-        table[index].remove(key);
+    // Grow once so that n entries fit under the max load factor
+    void reserve(size_t n) {
+        size_t c = capacity;
+        while (c * maxLoad < n) c <<= 1;
+        if (c != capacity) rehash(c);
+    }
+
+    // Insert n pairs - O(n); reserves room for all of them up front (an
+    // upper bound when the batch repeats keys), so the batch never rehashes
+    // more than once
+    void insertBatch(const pair<K, V>* items, size_t n) {
+        reserve(count + n);
+        for (size_t i = 0; i < n; i++) insert(items[i].first, items[i].second);
+    }
+
+    void insertBatch(const vector<pair<K, V>>& items) { insertBatch(items.data(), items.size()); }
+
+    // Look up n keys into out[0..n) (notFound where absent), returns hits
+    size_t getBatch(const K* keys, size_t n, V* out, const V& notFound = V()) const {
+        size_t hits = 0;
+        for (size_t i = 0; i < n; i++) {
+            size_t j = findSlot(keys[i]);
+            if (j == capacity) {
+                out[i] = notFound;
+            } else {
+                out[i] = slots[j].second;
+                hits++;
+            }
+        }
+        return hits;
+    }
+
+    size_t getBatch(const vector<K>& keys, vector<V>& out, const V& notFound = V()) const {
+        out.resize(keys.size());
+        return getBatch(keys.data(), keys.size(), out.data(), notFound);
+    }
+
+    // Search - O(1) average, nullptr if not found
+    template<typename Q>
+    V* find(const Q& key) {
+        return const_cast<V*>(as_const(*this).find(key));
+    }
+
+    template<typename Q>
+    const V* find(const Q& key) const {
+        size_t i = findSlot(lookupKey<K, Hash, Eq>(key));
+        return i == capacity ? nullptr : &slots[i].second;
+    }
+
+    // Search - O(1) average
+    template<typename Q>
+    V get(const Q& key, const V& notFound = V()) const {
+        const V* v = find(key);
+        return v ? *v : notFound;
+    }
+
+    // Delete - O(1) average, leaves a tombstone
+    template<typename Q>
+    void remove(const Q& key) {
+        size_t i = findSlot(lookupKey<K, Hash, Eq>(key));
+        if (i == capacity) return;
+        SlotTraits::destroy(alloc, slots + i);
+        setCtrl(i, DELETED);
         count--;
+        tombstones++;
     }
 
-    bool contains(int key) {
-        int index = hash(key);
-        for (int val : table[index]) {
-            if (val == key) return true;
+    // Contains - O(1) average
+    template<typename Q>
+    bool contains(const Q& key) const { return find(key) != nullptr; }
+
+    int size() const { return (int)count; }
+    bool isEmpty() const { return count == 0; }
+    size_t bucketCount() const { return capacity; }
+    float loadFactor() const { return (float)count / capacity; }
+};
+
+// Concurrent Hash Table (sharded, striped locks, seqlock reads)
+// The hash picks one of N shards. Writers take that shard's mutex and bump
+// its sequence counter to odd while they modify it; readers take no lock:
+// they read the counter, probe, and retry if it was odd or changed. Slots
+// are atomics (relaxed), so racing reads are well defined and the counter
+// check discards torn ones. A grown slot array is published with a pointer
+// swap. The old array stays allocated until the table is destroyed, since a
+// reader may still be probing it; only growth retires an array, and each one
+// is half the size of the next, so retired arrays never add up to more than
+// the live one. Purging tombstones rebuilds the array in place instead.
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class ConcurrentHashTable {
+    static_assert(is_trivially_copyable<K>::value && is_trivially_copyable<V>::value,
+                  "seqlock reads copy keys and values through std::atomic");
+
+private:
+    static const int8_t EMPTY = -128;
+    static const int8_t DELETED = -2;
+
+    struct Slot {
+        atomic<int8_t> ctrl{EMPTY};
+        atomic<K> key{};
+        atomic<V> value{};
+    };
+
+    struct SlotArray {
+        size_t capacity;
+        unique_ptr<Slot[]> slots;
+        explicit SlotArray(size_t cap) : capacity(cap), slots(new Slot[cap]) {}
+    };
+
+    struct alignas(64) Shard {
+        mutex writeLock;
+        atomic<uint64_t> seq{0};
+        atomic<SlotArray*> array{nullptr};
+        size_t count = 0;
+        size_t tombstones = 0;
+        vector<unique_ptr<SlotArray>> arrays;  // Current one last, smaller ones retired by growth
+    };
+
+    unique_ptr<Shard[]> shards;
+    size_t shardMask;
+    float maxLoad;
+    Hash hasher;
+
+    Shard& shardFor(size_t h) const { return shards[(h >> 40) & shardMask]; }
+    static size_t startPos(size_t h, size_t mask) { return (h >> 7) & mask; }
+    static int8_t tag(size_t h) { return (int8_t)(h & 0x7F); }
+
+    // Writer side: the shard lock is held
+    static size_t findSlot(const SlotArray* a, size_t h, const K& key) {
+        size_t mask = a->capacity - 1;
+        for (size_t i = startPos(h, mask), n = 0; n < a->capacity; i = (i + 1) & mask, n++) {
+            int8_t c = a->slots[i].ctrl.load(memory_order_relaxed);
+            if (c == EMPTY) break;
+            if (c == tag(h) && a->slots[i].key.load(memory_order_relaxed) == key) return i;
         }
-        return false;
+        return a->capacity;
+    }
+
+    static size_t findFree(const SlotArray* a, size_t h) {
+        size_t mask = a->capacity - 1;
+        size_t i = startPos(h, mask);
+        while (a->slots[i].ctrl.load(memory_order_relaxed) >= 0) i = (i + 1) & mask;
+        return i;
+    }
+
+    // Copy live entries into a larger array; readers keep using the old one
+    // until the pointer swap, and its contents are unchanged meanwhile
+    void grow(Shard& s, size_t newCap) {
+        const SlotArray* old = s.array.load(memory_order_relaxed);
+        auto fresh = make_unique<SlotArray>(newCap);
+        for (size_t i = 0; i < old->capacity; i++) {
+            const Slot& from = old->slots[i];
+            if (from.ctrl.load(memory_order_relaxed) < 0) continue;
+            K key = from.key.load(memory_order_relaxed);
+            Slot& to = fresh->slots[findFree(fresh.get(), hasher(key))];
+            to.key.store(key, memory_order_relaxed);
+            to.value.store(from.value.load(memory_order_relaxed), memory_order_relaxed);
+            to.ctrl.store(from.ctrl.load(memory_order_relaxed), memory_order_relaxed);
+        }
+        s.tombstones = 0;
+        s.array.store(fresh.get(), memory_order_release);
+        s.arrays.push_back(move(fresh));
+    }
+
+    // Drop tombstones without allocating a new array: save the live entries,
+    // clear the slots and reinsert. This runs inside one write section, so a
+    // reader probing meanwhile sees the counter change and retries.
+    void purgeTombstones(Shard& s) {
+        SlotArray* a = s.array.load(memory_order_relaxed);
+        vector<pair<K, V>> live;
+        live.reserve(s.count);
+        for (size_t i = 0; i < a->capacity; i++) {
+            const Slot& slot = a->slots[i];
+            if (slot.ctrl.load(memory_order_relaxed) < 0) continue;
+            live.emplace_back(slot.key.load(memory_order_relaxed), slot.value.load(memory_order_relaxed));
+        }
+        beginWrite(s);
+        for (size_t i = 0; i < a->capacity; i++) a->slots[i].ctrl.store(EMPTY, memory_order_relaxed);
+        for (auto& entry : live) {
+            size_t h = hasher(entry.first);
+            Slot& slot = a->slots[findFree(a, h)];
+            slot.key.store(entry.first, memory_order_relaxed);
+            slot.value.store(entry.second, memory_order_relaxed);
+            slot.ctrl.store(tag(h), memory_order_relaxed);
+        }
+        endWrite(s);
+        s.tombstones = 0;
+    }
+
+    void beginWrite(Shard& s) {
+        s.seq.store(s.seq.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
     }
 
-    int size() { return count; }
+    void endWrite(Shard& s) {
+        s.seq.store(s.seq.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+public:
+    ConcurrentHashTable(size_t shardCount = 64, size_t capPerShard = 16, float maxLoadFactor = 0.75f,
+                        const Hash& h = Hash())
+        : maxLoad(min(max(maxLoadFactor, 0.25f), 0.9f)), hasher(h) {
+        size_t n = 1;
+        while (n < shardCount) n <<= 1;
+        shards.reset(new Shard[n]);
+        shardMask = n - 1;
+        size_t cap = 8;
+        while (cap * maxLoad < capPerShard) cap <<= 1;
+        for (size_t i = 0; i < n; i++) {
+            shards[i].arrays.push_back(make_unique<SlotArray>(cap));
+            shards[i].array.store(shards[i].arrays.back().get(), memory_order_relaxed);
+        }
+    }
+
+    // Insert - O(1) average, locks one shard
+    void insert(const K& key, const V& value) {
+        size_t h = hasher(key);
+        Shard& s = shardFor(h);
+        lock_guard<mutex> guard(s.writeLock);
+        SlotArray* a = s.array.load(memory_order_relaxed);
+        size_t i = findSlot(a, h, key);
+        if (i == a->capacity && s.count + s.tombstones + 1 > a->capacity * maxLoad) {
+            if (s.count + 1 > a->capacity * maxLoad / 2) grow(s, a->capacity * 2);
+            else purgeTombstones(s);  // Mostly tombstones: same capacity is enough
+            a = s.array.load(memory_order_relaxed);
+            i = a->capacity;  // Still absent
+        }
+
+        beginWrite(s);
+        if (i != a->capacity) {
+            a->slots[i].value.store(value, memory_order_relaxed);  // Update existing
+        } else {
+            Slot& slot = a->slots[findFree(a, h)];
+            if (slot.ctrl.load(memory_order_relaxed) == DELETED) s.tombstones--;
+            slot.key.store(key, memory_order_relaxed);
+            slot.value.store(value, memory_order_relaxed);
+            slot.ctrl.store(tag(h), memory_order_relaxed);
+            s.count++;
+        }
+        endWrite(s);
+    }
+
+    // Delete - O(1) average, locks one shard, leaves a tombstone
+    void remove(const K& key) {
+        size_t h = hasher(key);
+        Shard& s = shardFor(h);
+        lock_guard<mutex> guard(s.writeLock);
+        SlotArray* a = s.array.load(memory_order_relaxed);
+        size_t i = findSlot(a, h, key);
+        if (i == a->capacity) return;
+        beginWrite(s);
+        a->slots[i].ctrl.store(DELETED, memory_order_relaxed);
+        endWrite(s);
+        s.count--;
+        s.tombstones++;
+    }
+
+    // Search - O(1) average, lock-free; retries only if a writer touched
+    // the same shard meanwhile
+    bool find(const K& key, V& out) const {
+        size_t h = hasher(key);
+        Shard& s = shardFor(h);
+        for (;;) {
+            uint64_t before = s.seq.load(memory_order_acquire);
+            if (before & 1) {
+                this_thread::yield();  // Writer in progress
+                continue;
+            }
+            const SlotArray* a = s.array.load(memory_order_acquire);
+            size_t mask = a->capacity - 1;
+            bool found = false;
+            V value{};
+            for (size_t i = startPos(h, mask), n = 0; n < a->capacity; i = (i + 1) & mask, n++) {
+                const Slot& slot = a->slots[i];
+                int8_t c = slot.ctrl.load(memory_order_relaxed);
+                if (c == EMPTY) break;
+                if (c == tag(h) && slot.key.load(memory_order_relaxed) == key) {
+                    value = slot.value.load(memory_order_relaxed);
+                    found = true;
+                    break;
+                }
+            }
+            atomic_thread_fence(memory_order_acquire);
+            if (s.seq.load(memory_order_relaxed) == before) {
+                if (found) out = value;
+                return found;
+            }
+        }
+    }
+
+    V get(const K& key, const V& notFound = V()) const {
+        V value;
+        return find(key, value) ? value : notFound;
+    }
+
+    bool contains(const K& key) const {
+        V value;
+        return find(key, value);
+    }
+
+    // Sum of shard sizes; exact only when no writer is running
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i <= shardMask; i++) {
+            lock_guard<mutex> guard(shards[i].writeLock);
+            total += shards[i].count;
+        }
+        return total;
+    }
+
+    size_t shardCount() const { return shardMask + 1; }
 };
 
+// Benchmark: chain lengths under adversarial keys
+// Identity hashing ("key % capacity") puts every multiple of the capacity in
+// bucket 0; the avalanche-mixed default spreads them like random keys.
+template<typename Hash>
+void reportChains(const string& name, const vector<int>& keys, size_t buckets) {
+    HashTable<int, int, Hash> ht(buckets);
+    for (int k : keys) ht.insert(k, k);
+
+    auto start = chrono::steady_clock::now();
+    long long found = 0;
+    for (int rep = 0; rep < 20; rep++) {
+        for (int k : keys) found += ht.contains(k);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()
+                / (20.0 * keys.size());
+
+    vector<size_t> hist = ht.chainLengthHistogram();
+    size_t fourPlus = 0;
+    for (size_t len = 4; len < hist.size(); len++) fourPlus += hist[len];
+    printf("  %-9s len0=%-5zu len1=%-5zu len2=%-5zu len3=%-5zu len4+=%-5zu max=%-5zu %7.1f ns/lookup\n",
+           name.c_str(), hist.size() > 0 ? hist[0] : 0, hist.size() > 1 ? hist[1] : 0,
+           hist.size() > 2 ? hist[2] : 0, hist.size() > 3 ? hist[3] : 0, fourPlus,
+           hist.size() - 1, ns);
+    if (found != 20LL * (long long)keys.size()) cout << "  lookup mismatch!\n";
+}
+
+void benchmarkChainLengths() {
+    const size_t buckets = 1024;
+    const int n = 1024;
+    vector<pair<string, vector<int>>> keySets(4);
+    keySets[0].first = "sequential";
+    keySets[1].first = "multiples of capacity";
+    keySets[2].first = "shared low 16 bits";
+    keySets[3].first = "negative strided";
+    for (int i = 0; i < n; i++) {
+        keySets[0].second.push_back(i);
+        keySets[1].second.push_back(i * (int)buckets);
+        keySets[2].second.push_back(i << 16);
+        keySets[3].second.push_back(-i * 4096);
+    }
+    for (auto& set : keySets) {
+        cout << set.first << " (" << n << " keys, " << buckets << " buckets):\n";
+        reportChains<IdentityHash>("identity", set.second, buckets);
+        reportChains<DefaultHash<int>>("default", set.second, buckets);
+    }
+}
+
+// Benchmark: insert latency with stop-the-world vs incremental rehash
+// Percentiles of per-insert wall time; the stop-the-world tail is the pause
+// that moves the whole table when it doubles.
+void benchmarkRehashLatency(int n) {
+    vector<int> keys(n);
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < n; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;  // xorshift64
+        keys[i] = (int)x;
+    }
+    for (RehashMode mode : {RehashMode::StopTheWorld, RehashMode::Incremental}) {
+        HashTable<int, int> ht(16, 1.0f, mode);
+        vector<double> latency(n);
+        auto total = chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            auto start = chrono::steady_clock::now();
+            ht.insert(keys[i], i);
+            latency[i] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - total).count();
+        sort(latency.begin(), latency.end());
+        auto pct = [&](double p) { return latency[min<size_t>(n - 1, (size_t)(p * n))]; };
+        printf("  %-14s p50=%6.0fns p99=%8.0fns p999=%8.0fns p9999=%10.0fns max=%10.0fns total=%6.0fms\n",
+               mode == RehashMode::StopTheWorld ? "stop-the-world" : "incremental",
+               pct(0.50), pct(0.99), pct(0.999), pct(0.9999), latency[n - 1], ms);
+    }
+}
+
+// Benchmark: multi-threaded throughput, 90% lookups / 5% inserts / 5% removes
+// One FlatHashTable behind a global mutex vs the sharded table. Keys come from
+// the whole range and half of them start present, so writes really insert and
+// remove, and the tombstone purge and growth paths run during the timing.
+template<typename Table, typename Lookup, typename Insert, typename Remove>
+double runThroughput(Table& table, int threads, int opsPerThread, int keyRange,
+                     Lookup lookup, Insert insert, Remove remove) {
+    vector<thread> workers;
+    atomic<long long> hits{0};
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            uint64_t x = 0x9E3779B97F4A7C15ULL * (t + 1);
+            long long local = 0;
+            for (int i = 0; i < opsPerThread; i++) {
+                x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                int key = (int)((x >> 8) % keyRange);
+                int op = x % 20;
+                if (op == 0) insert(table, key, i);
+                else if (op == 1) remove(table, key);
+                else local += lookup(table, key);
+            }
+            hits += local;
+        });
+    }
+    for (auto& w : workers) w.join();
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return threads * (double)opsPerThread / sec / 1e6;
+}
+
+void benchmarkConcurrentThroughput(int keyRange, int opsPerThread) {
+    struct LockedTable {
+        mutex lock;
+        FlatHashTable<int, int> table;
+    };
+    LockedTable locked;
+    ConcurrentHashTable<int, int> sharded;
+    for (int k = 0; k < keyRange; k += 2) {
+        locked.table.insert(k, k);
+        sharded.insert(k, k);
+    }
+
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    for (int t : counts) {
+        double global = runThroughput(locked, t, opsPerThread, keyRange,
+            [](LockedTable& lt, int k) { lock_guard<mutex> g(lt.lock); return lt.table.contains(k); },
+            [](LockedTable& lt, int k, int v) { lock_guard<mutex> g(lt.lock); lt.table.insert(k, v); },
+            [](LockedTable& lt, int k) { lock_guard<mutex> g(lt.lock); lt.table.remove(k); });
+        double shardedMops = runThroughput(sharded, t, opsPerThread, keyRange,
+            [](ConcurrentHashTable<int, int>& ct, int k) { return ct.contains(k); },
+            [](ConcurrentHashTable<int, int>& ct, int k, int v) { ct.insert(k, v); },
+            [](ConcurrentHashTable<int, int>& ct, int k) { ct.remove(k); });
+        printf("  %3d threads: global mutex %7.1f Mops/s, sharded %7.1f Mops/s\n", t, global, shardedMops);
+    }
+
+    // Every shard's count must match the keys a full scan can find
+    size_t present = 0;
+    for (int k = 0; k < keyRange; k++) present += sharded.contains(k);
+    if (present != sharded.size()) cout << "  sharded size mismatch!\n";
+}
+
+// Benchmark: batched vs scalar operations on a table larger than the LLC
+// n int -> int entries occupy ~18 bytes per entry at the default load
+void benchmarkBatchLookups(int n) {
+    vector<pair<int, int>> items(n);
+    uint64_t x = 0x2545F4914F6CDD1DULL;
+    for (int i = 0; i < n; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        items[i] = {(int)x, i};
+    }
+    vector<int> queries(n);
+    for (int i = 0; i < n; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        queries[i] = items[x % n].first;  // Random order, all hits
+    }
+
+    auto time = [](auto&& body) {
+        auto start = chrono::steady_clock::now();
+        body();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    FlatHashTable<int, int> scalar, batched;
+    scalar.reserve(n);
+    batched.reserve(n);
+    double insertScalar = time([&] { for (auto& p : items) scalar.insert(p.first, p.second); });
+    double insertBatched = time([&] { batched.insertBatch(items); });
+
+    long long sum = 0;
+    vector<int> out(n);  // Sized before timing, so getBatch does not fault pages in
+    double getScalar = time([&] { for (int k : queries) sum += scalar.get(k, -1); });
+    double getBatched = time([&] {
+        batched.getBatch(queries, out, -1);
+        for (int v : out) sum -= v;
+    });
+
+    printf("  %d entries, %zu slots (%.0f MB)\n", n, scalar.bucketCount(),
+           scalar.bucketCount() * (sizeof(pair<int, int>) + 1) / 1e6);
+    printf("  insert: scalar %6.1f ns/op, batch %6.1f ns/op\n",
+           insertScalar * 1e6 / n, insertBatched * 1e6 / n);
+    printf("  get:    scalar %6.1f ns/op, batch %6.1f ns/op\n",
+           getScalar * 1e6 / n, getBatched * 1e6 / n);
+    if (sum != 0) cout << "  batch/scalar mismatch!\n";
+}
+
 int main() {
     cout << "=== Hash Table ===\n";
-    HashTable ht;
+    HashTable<int, int> ht;
     ht.insert(1, 100);
-    ht.insert(11, 200);  // Same bucket as 1
+    ht.insert(11, 200);
     ht.insert(2, 300);
     ht.insert(21, 400);
     ht.print();
 
-    cout << "Get key 11: " << ht.get(11) << endl;
+    cout << "Get key 11: " << ht.get(11, -1) << endl;
     cout << "Contains 2: " << (ht.contains(2) ? "Yes" : "No") << endl;
 
     ht.remove(11);
@@ -138,7 +1052,7 @@ int main() {
     ht.print();
 
     cout << "\n=== Hash Set ===\n";
-    HashSet hs;
+    HashSet<int> hs;
     hs.add(5);
     hs.add(10);
     hs.add(15);
@@ -146,5 +1060,60 @@ int main() {
     hs.remove(10);
     cout << "After remove, contains 10: " << (hs.contains(10) ? "Yes" : "No") << endl;
 
+    cout << "\n=== Flat Hash Table ===\n";
+    FlatHashTable<int, int> fht(4, 0.75f);
+    for (int i = 0; i < 100; i++) {
+        fht.insert(i * 7, i);  // Grows past the initial 16 slots
+    }
+    cout << "Size: " << fht.size() << ", slots: " << fht.bucketCount()
+         << ", load: " << fht.loadFactor() << endl;
+    cout << "Get key 70: " << fht.get(70, -1) << endl;  // 10
+    fht.remove(70);
+    cout << "After remove, contains 70: " << (fht.contains(70) ? "Yes" : "No") << endl;
+    cout << "Get key -5: " << fht.get(-5, -1) << endl;  // -1
+
+    cout << "\n=== String Keys (heterogeneous lookup) ===\n";
+    FlatHashTable<string, int> wordCount;
+    for (string w : {"apple", "banana", "apple", "cherry", "banana", "apple"}) {
+        int* c = wordCount.find(w);
+        if (c) (*c)++;
+        else wordCount.insert(w, 1);
+    }
+    string_view query = "apple";
+    cout << "apple: " << wordCount.get(query) << endl;  // 3, no string copy
+    cout << "banana: " << wordCount.get("banana") << endl;  // 2
+
+    cout << "\n=== Batch Operations ===\n";
+    FlatHashTable<int, int> bt;
+    bt.insertBatch({{1, 10}, {2, 20}, {3, 30}});
+    vector<int> found;
+    cout << "Hits: " << bt.getBatch({1, 4, 3}, found, -1) << ", values: ";  // 2
+    for (int v : found) cout << v << " ";  // 10 -1 30
+    cout << endl;
+
+    cout << "\n=== Benchmark: Chain Lengths ===\n";
+    benchmarkChainLengths();
+
+    cout << "\n=== Benchmark: Rehash Latency (2M inserts) ===\n";
+    benchmarkRehashLatency(2000000);
+
+    cout << "\n=== Benchmark: Batch vs Scalar (4M entries) ===\n";
+    benchmarkBatchLookups(4000000);
+
+    cout << "\n=== Concurrent Hash Table ===\n";
+    ConcurrentHashTable<int, int> cht(16);
+    vector<thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&cht, t] {
+            for (int i = t; i < 10000; i += 4) cht.insert(i, i * i);
+        });
+    }
+    for (auto& w : writers) w.join();
+    cout << "Size: " << cht.size() << " across " << cht.shardCount() << " shards" << endl;  // 10000
+    cout << "Get key 99: " << cht.get(99, -1) << endl;  // 9801
+
+    cout << "\n=== Benchmark: Concurrent Throughput (1M keys, 90% reads, 5% inserts, 5% removes) ===\n";
+    benchmarkConcurrentThroughput(1 << 20, 1000000);
+
     return 0;
 }
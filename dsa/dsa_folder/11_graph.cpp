@@ -5,6 +5,21 @@
 #include <list>
 #include <climits>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
 // Graph using Adjacency List
@@ -45,6 +60,12 @@ public:
         return false;
     }
 
+    int numVertices() const { return V; }
+    bool isDirected() const { return directed; }
+
+    // Adjacency of u as stored: {neighbor, weight}
+    const list<pair<int, int>>& adjacency(int u) const { return adj[u]; }
+
     // Get neighbors - O(1)
     vector<int> getNeighbors(int u) {
         vector<int> neighbors;
@@ -78,12 +99,24 @@ public:
     }
 
     // DFS - O(V + E)
+    // Explicit stack of {vertex, next neighbor}, the state a recursive call
+    // would keep, so the order matches recursion without its depth limit
     void DFSUtil(int u, vector<bool>& visited) {
+        vector<pair<int, list<pair<int, int>>::iterator>> st;
         visited[u] = true;
         cout << u << " ";
-        for (auto& p : adj[u]) {
-            if (!visited[p.first]) {
-                DFSUtil(p.first, visited);
+        st.push_back({u, adj[u].begin()});
+        while (!st.empty()) {
+            auto& top = st.back();
+            if (top.second == adj[top.first].end()) {
+                st.pop_back();
+                continue;
+            }
+            int v = (top.second++)->first;
+            if (!visited[v]) {
+                visited[v] = true;
+                cout << v << " ";
+                st.push_back({v, adj[v].begin()});
             }
         }
     }
@@ -157,11 +190,24 @@ public:
     }
 
     bool hasCycleUtil(int u, vector<bool>& visited, int parent) {
+        struct Frame {
+            int u, parent;
+            list<pair<int, int>>::iterator next;
+        };
+        vector<Frame> st;
         visited[u] = true;
-        for (auto& p : adj[u]) {
-            if (!visited[p.first]) {
-                if (hasCycleUtil(p.first, visited, u)) return true;
-            } else if (p.first != parent) {
+        st.push_back({u, parent, adj[u].begin()});
+        while (!st.empty()) {
+            Frame& top = st.back();
+            if (top.next == adj[top.u].end()) {
+                st.pop_back();
+                continue;
+            }
+            int v = (top.next++)->first;
+            if (!visited[v]) {
+                visited[v] = true;
+                st.push_back({v, top.u, adj[v].begin()});
+            } else if (v != top.parent) {
                 return true;
             }
         }
@@ -170,13 +216,22 @@ public:
 
     // Topological Sort (for DAG) - O(V + E)
     void topologicalSortUtil(int u, vector<bool>& visited, stack<int>& st) {
+        vector<pair<int, list<pair<int, int>>::iterator>> frames;
         visited[u] = true;
-        for (auto& p : adj[u]) {
-            if (!visited[p.first]) {
-                topologicalSortUtil(p.first, visited, st);
+        frames.push_back({u, adj[u].begin()});
+        while (!frames.empty()) {
+            auto& top = frames.back();
+            if (top.second == adj[top.first].end()) {
+                st.push(top.first);  // Finished: all descendants are already on st
+                frames.pop_back();
+                continue;
+            }
+            int v = (top.second++)->first;
+            if (!visited[v]) {
+                visited[v] = true;
+                frames.push_back({v, adj[v].begin()});
             }
         }
-        st.push(u);
     }
 
     void topologicalSort() {
@@ -220,11 +275,22 @@ public:
     // Count connected components - O(V + E)
     int countComponents() {
         vector<bool> visited(V, false);
+        vector<int> st;
         int count = 0;
         for (int i = 0; i < V; i++) {
-            if (!visited[i]) {
-                DFSUtil(i, visited);
-                count++;
+            if (visited[i]) continue;
+            count++;
+            visited[i] = true;
+            st.push_back(i);
+            while (!st.empty()) {
+                int u = st.back();
+                st.pop_back();
+                for (auto& p : adj[u]) {
+                    if (!visited[p.first]) {
+                        visited[p.first] = true;
+                        st.push_back(p.first);
+                    }
+                }
             }
         }
         return count;
@@ -267,50 +333,2739 @@ public:
     }
 };
 
-int main() {
-    cout << "=== Undirected Graph ===\n";
-    Graph g1(6);
-    g1.addEdge(0, 1);
-    g1.addEdge(0, 2);
-    g1.addEdge(1, 3);
-    g1.addEdge(2, 3);
-    g1.addEdge(3, 4);
-    g1.addEdge(4, 5);
-    g1.print();
+// Edge for building immutable graphs
+struct Edge {
+    int u, v, weight;
+};
 
-    g1.BFS(0);
-    g1.DFS(0);
-    g1.DFSIterative(0);
+// On-disk CSR layout (version 1, native little-endian). Sections start at
+// 64-byte aligned positions so a mapped file can be used in place.
+struct CSRFileHeader {
+    static const uint64_t MAGIC = 0x3148504152475343ULL;  // "CSGRAPH1" on disk
+    static const uint32_t VERSION = 1;
+    enum : uint32_t { DIRECTED = 1, WEIGHTED = 2, CHECKSUMS = 4 };
 
-    cout << "Has cycle: " << (g1.hasCycleUndirected() ? "Yes" : "No") << endl;
-    cout << "Is bipartite: " << (g1.isBipartite() ? "Yes" : "No") << endl;
+    uint64_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t flags = 0;
+    uint64_t vertices = 0;
+    uint64_t arcs = 0;
+    int32_t maxWeight = 0;
+    uint32_t reserved = 0;
+    uint64_t offsetsPos = 0, targetsPos = 0, weightsPos = 0, fileBytes = 0;
+    uint64_t sectionChecksums[3] = {0, 0, 0};  // offsets, targets, weights
+    uint64_t headerChecksum = 0;               // Over every field above
 
-    cout << "\n=== Directed Weighted Graph ===\n";
-    Graph g2(5, true);
-    g2.addEdge(0, 1, 4);
-    g2.addEdge(0, 2, 1);
-    g2.addEdge(2, 1, 2);
-    g2.addEdge(1, 3, 1);
-    g2.addEdge(2, 3, 5);
-    g2.addEdge(3, 4, 3);
-    g2.print();
+    static uint64_t align(uint64_t pos) { return (pos + 63) & ~63ULL; }
 
-    vector<int> dist = g2.dijkstra(0);
-    cout << "Dijkstra from 0: ";
-    for (int i = 0; i < 5; i++) {
-        cout << "to " << i << "=" << dist[i] << " ";
+    void computeLayout() {
+        offsetsPos = align(sizeof(CSRFileHeader));
+        targetsPos = align(offsetsPos + (vertices + 1) * sizeof(long long));
+        weightsPos = align(targetsPos + arcs * sizeof(int));
+        fileBytes = weightsPos + ((flags & WEIGHTED) ? arcs * sizeof(int) : 0);
     }
-    cout << endl;
+};
 
-    cout << "\n=== DAG Topological Sort ===\n";
-    Graph g3(6, true);
-    g3.addEdge(5, 2);
-    g3.addEdge(5, 0);
-    g3.addEdge(4, 0);
-    g3.addEdge(4, 1);
-    g3.addEdge(2, 3);
-    g3.addEdge(3, 1);
-    g3.topologicalSort();
+// 64-bit checksum, one multiply per 8-byte word
+uint64_t checksum64(const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ bytes;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+    }
+    for (; i < bytes; i++) h = (h ^ p[i]) * 0x100000001B3ULL;
+    return h ^ (h >> 29);
+}
+
+// Compressed Sparse Row graph (immutable)
+// The neighbors of u are adj[offsets[u] .. offsets[u + 1]) with matching
+// weights, so a traversal walks two flat arrays instead of chasing list
+// nodes. Undirected edges are stored in both directions, like Graph.
+// The arrays are either owned vectors or views into a mapped CSR file; the
+// algorithms only see the pointers, so both work the same.
+class CSRGraph {
+private:
+    int V;
+    bool directed;
+    int maxW = 0;
+    vector<long long> offsetStore{0};  // V + 1 entries when owned
+    vector<int> targetStore;
+    vector<int> weightStore;
+    const long long* offsets = nullptr;
+    const int* adj = nullptr;
+    const int* weights = nullptr;  // Null for unweighted files: every weight is 1
+    void* mapping = nullptr;
+    size_t mappingBytes = 0;
+
+    void useStore() {
+        offsets = offsetStore.data();
+        adj = targetStore.data();
+        weights = weightStore.data();
+    }
+
+public:
+    // Build from an edge list - O(V + E) counting sort by source
+    CSRGraph(int vertices, const vector<Edge>& edges, bool isDirected = false)
+        : V(vertices), directed(isDirected), offsetStore(vertices + 1, 0) {
+        for (const Edge& e : edges) {
+            offsetStore[e.u + 1]++;
+            if (!directed) offsetStore[e.v + 1]++;
+            maxW = max(maxW, e.weight);
+        }
+        for (int u = 0; u < V; u++) offsetStore[u + 1] += offsetStore[u];
+        targetStore.resize(offsetStore[V]);
+        weightStore.resize(offsetStore[V]);
+        vector<long long> next(offsetStore.begin(), offsetStore.end() - 1);
+        for (const Edge& e : edges) {
+            targetStore[next[e.u]] = e.v;
+            weightStore[next[e.u]++] = e.weight;
+            if (!directed) {
+                targetStore[next[e.v]] = e.u;
+                weightStore[next[e.v]++] = e.weight;
+            }
+        }
+        useStore();
+    }
+
+    // Snapshot of an adjacency-list Graph - O(V + E)
+    CSRGraph(const Graph& g) : V(g.numVertices()), directed(g.isDirected()), offsetStore(V + 1, 0) {
+        for (int u = 0; u < V; u++) offsetStore[u + 1] = offsetStore[u] + g.adjacency(u).size();
+        targetStore.reserve(offsetStore[V]);
+        weightStore.reserve(offsetStore[V]);
+        for (int u = 0; u < V; u++) {
+            for (auto& p : g.adjacency(u)) {
+                targetStore.push_back(p.first);
+                weightStore.push_back(p.second);
+                maxW = max(maxW, p.second);
+            }
+        }
+        useStore();
+    }
+
+    // Empty graph, e.g. to mapFile() into
+    CSRGraph() : V(0), directed(false) { useStore(); }
+
+    // Copies always own their arrays, even when the source is mapped
+    CSRGraph(const CSRGraph& o)
+        : V(o.V), directed(o.directed), maxW(o.maxW),
+          offsetStore(o.offsets, o.offsets + o.V + 1),
+          targetStore(o.adj, o.adj + o.numArcs()) {
+        if (o.weights) weightStore.assign(o.weights, o.weights + o.numArcs());
+        else weightStore.assign(o.numArcs(), 1);
+        useStore();
+    }
+
+    CSRGraph(CSRGraph&& o) noexcept : CSRGraph() { swap(o); }
+
+    CSRGraph& operator=(CSRGraph o) {
+        swap(o);
+        return *this;
+    }
+
+    ~CSRGraph() {
+        if (mapping) munmap(mapping, mappingBytes);
+    }
+
+    void swap(CSRGraph& o) noexcept {
+        std::swap(V, o.V);
+        std::swap(directed, o.directed);
+        std::swap(maxW, o.maxW);
+        offsetStore.swap(o.offsetStore);  // Vector swaps keep each buffer's address
+        targetStore.swap(o.targetStore);
+        weightStore.swap(o.weightStore);
+        std::swap(offsets, o.offsets);
+        std::swap(adj, o.adj);
+        std::swap(weights, o.weights);
+        std::swap(mapping, o.mapping);
+        std::swap(mappingBytes, o.mappingBytes);
+    }
+
+    // Write the binary CSR format that mapFile() reads
+    bool save(const string& path, bool withChecksums = true) const {
+        CSRFileHeader h;
+        h.flags = (directed ? CSRFileHeader::DIRECTED : 0u) | CSRFileHeader::WEIGHTED |
+                  (withChecksums ? CSRFileHeader::CHECKSUMS : 0u);
+        h.vertices = V;
+        h.arcs = numArcs();
+        h.maxWeight = maxW;
+        h.computeLayout();
+        vector<int> unitWeights;
+        const int* w = weights;
+        if (!w) {
+            unitWeights.assign(numArcs(), 1);
+            w = unitWeights.data();
+        }
+        if (withChecksums) {
+            h.sectionChecksums[0] = checksum64(offsets, (V + 1) * sizeof(long long));
+            h.sectionChecksums[1] = checksum64(adj, numArcs() * sizeof(int));
+            h.sectionChecksums[2] = checksum64(w, numArcs() * sizeof(int));
+        }
+        h.headerChecksum = checksum64(&h, offsetof(CSRFileHeader, headerChecksum));
+
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        static const char zeros[64] = {};
+        bool ok = true;
+        uint64_t written = 0;
+        // Short writes (e.g. a full disk) fail the save instead of leaving a truncated file
+        auto writeAt = [&](uint64_t pos, const void* data, size_t bytes) {
+            size_t gap = pos - written;
+            ok = ok && fwrite(zeros, 1, gap, f) == gap && (!bytes || fwrite(data, 1, bytes, f) == bytes);
+            written = pos + bytes;
+        };
+        writeAt(0, &h, sizeof(h));
+        writeAt(h.offsetsPos, offsets, (V + 1) * sizeof(long long));
+        writeAt(h.targetsPos, adj, numArcs() * sizeof(int));
+        writeAt(h.weightsPos, w, numArcs() * sizeof(int));
+        return fclose(f) == 0 && ok;
+    }
+
+    // Map a binary CSR file and use it in place - O(1) unless verifying.
+    // The header is always validated. verify also checks that offsets are
+    // monotone with targets in range and, if the file was saved with them,
+    // the section checksums, which reads the whole file.
+    bool mapFile(const string& path, bool verify = false) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(CSRFileHeader)) {
+            p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        const char* base = (const char*)p;
+        CSRFileHeader h;
+        memcpy(&h, base, sizeof(h));
+        bool ok = h.magic == CSRFileHeader::MAGIC && h.version == CSRFileHeader::VERSION &&
+                  h.headerChecksum == checksum64(&h, offsetof(CSRFileHeader, headerChecksum)) &&
+                  h.vertices <= INT_MAX && h.fileBytes <= (uint64_t)st.st_size;
+        if (ok) {
+            CSRFileHeader expected = h;
+            expected.computeLayout();
+            ok = expected.offsetsPos == h.offsetsPos && expected.targetsPos == h.targetsPos &&
+                 expected.weightsPos == h.weightsPos && expected.fileBytes == h.fileBytes;
+        }
+        const long long* off = ok ? (const long long*)(base + h.offsetsPos) : nullptr;
+        ok = ok && off[0] == 0 && off[h.vertices] == (long long)h.arcs;
+        bool weighted = h.flags & CSRFileHeader::WEIGHTED;
+        if (ok && verify && (h.flags & CSRFileHeader::CHECKSUMS)) {
+            ok = checksum64(off, (h.vertices + 1) * sizeof(long long)) == h.sectionChecksums[0] &&
+                 checksum64(base + h.targetsPos, h.arcs * sizeof(int)) == h.sectionChecksums[1] &&
+                 (!weighted || checksum64(base + h.weightsPos, h.arcs * sizeof(int)) == h.sectionChecksums[2]);
+        }
+        if (ok && verify) {
+            for (uint64_t u = 0; ok && u < h.vertices; u++) ok = off[u] <= off[u + 1];
+            const int* t = (const int*)(base + h.targetsPos);
+            for (uint64_t e = 0; ok && e < h.arcs; e++) ok = t[e] >= 0 && (uint64_t)t[e] < h.vertices;
+        }
+        if (!ok) {
+            munmap(p, st.st_size);
+            return false;
+        }
+
+        CSRGraph mapped;
+        mapped.V = h.vertices;
+        mapped.directed = h.flags & CSRFileHeader::DIRECTED;
+        mapped.maxW = weighted ? h.maxWeight : 1;
+        mapped.offsets = off;
+        mapped.adj = (const int*)(base + h.targetsPos);
+        mapped.weights = weighted ? (const int*)(base + h.weightsPos) : nullptr;
+        mapped.mapping = p;
+        mapped.mappingBytes = st.st_size;
+        swap(mapped);
+        return true;
+    }
+
+    bool isMapped() const { return mapping != nullptr; }
+
+    int numVertices() const { return V; }
+    long long numArcs() const { return offsets[V]; }  // Undirected edges count twice
+    bool isDirected() const { return directed; }
+    int maxWeight() const { return maxW; }
+
+    // Arcs of u are the indices [edgeBegin(u), edgeEnd(u))
+    long long edgeBegin(int u) const { return offsets[u]; }
+    long long edgeEnd(int u) const { return offsets[u + 1]; }
+    int degree(int u) const { return offsets[u + 1] - offsets[u]; }
+    int target(long long e) const { return adj[e]; }
+    int weight(long long e) const { return weights ? weights[e] : 1; }
+
+    size_t memoryBytes() const {
+        return (V + 1) * sizeof(long long) + numArcs() * sizeof(int) * (weights ? 2 : 1);
+    }
+
+    // BFS - O(V + E), returns the visit order
+    vector<int> BFS(int start) const {
+        vector<bool> visited(V, false);
+        vector<int> order;
+        order.push_back(start);
+        visited[start] = true;
+        for (size_t head = 0; head < order.size(); head++) {
+            int u = order[head];
+            for (long long e = edgeBegin(u); e < edgeEnd(u); e++) {
+                if (!visited[adj[e]]) {
+                    visited[adj[e]] = true;
+                    order.push_back(adj[e]);
+                }
+            }
+        }
+        return order;
+    }
+
+    // Dijkstra's Algorithm - O((V+E) log V)
+    vector<int> dijkstra(int src) const {
+        vector<int> dist(V, INT_MAX);
+        priority_queue<pair<int,int>, vector<pair<int,int>>, greater<pair<int,int>>> pq;
+
+        dist[src] = 0;
+        pq.push({0, src});
+
+        while (!pq.empty()) {
+            int u = pq.top().second;
+            int d = pq.top().first;
+            pq.pop();
+
+            if (d > dist[u]) continue;
+
+            for (long long e = edgeBegin(u); e < edgeEnd(u); e++) {
+                int v = adj[e];
+                if (d + weight(e) < dist[v]) {
+                    dist[v] = d + weight(e);
+                    pq.push({dist[v], v});
+                }
+            }
+        }
+        return dist;
+    }
+
+    // Shortest path in unweighted graph - O(V + E)
+    vector<int> shortestPath(int src) const {
+        vector<int> dist(V, INT_MAX);
+        vector<int> queue;
+        queue.reserve(V);
+        dist[src] = 0;
+        queue.push_back(src);
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            int u = queue[head];
+            for (long long e = edgeBegin(u); e < edgeEnd(u); e++) {
+                if (dist[adj[e]] == INT_MAX) {
+                    dist[adj[e]] = dist[u] + 1;
+                    queue.push_back(adj[e]);
+                }
+            }
+        }
+        return dist;
+    }
+
+    // Count connected components - O(V + E), BFS over undirected arcs
+    int countComponents() const {
+        vector<bool> visited(V, false);
+        vector<int> queue;
+        queue.reserve(V);
+        int count = 0;
+        for (int i = 0; i < V; i++) {
+            if (visited[i]) continue;
+            count++;
+            queue.clear();
+            queue.push_back(i);
+            visited[i] = true;
+            for (size_t head = 0; head < queue.size(); head++) {
+                int u = queue[head];
+                for (long long e = edgeBegin(u); e < edgeEnd(u); e++) {
+                    if (!visited[adj[e]]) {
+                        visited[adj[e]] = true;
+                        queue.push_back(adj[e]);
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    // Check if graph is bipartite - O(V + E)
+    bool isBipartite() const {
+        vector<int> color(V, -1);
+        vector<int> queue;
+        queue.reserve(V);
+        for (int i = 0; i < V; i++) {
+            if (color[i] != -1) continue;
+            queue.clear();
+            queue.push_back(i);
+            color[i] = 0;
+            for (size_t head = 0; head < queue.size(); head++) {
+                int u = queue[head];
+                for (long long e = edgeBegin(u); e < edgeEnd(u); e++) {
+                    int v = adj[e];
+                    if (color[v] == -1) {
+                        color[v] = 1 - color[u];
+                        queue.push_back(v);
+                    } else if (color[v] == color[u]) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // Reverse every arc - O(V + E). Undirected graphs are their own transpose.
+    CSRGraph transpose() const {
+        vector<Edge> reversed;
+        reversed.reserve(numArcs());
+        for (int u = 0; u < V; u++) {
+            for (long long e = edgeBegin(u); e < edgeEnd(u); e++) reversed.push_back({adj[e], u, weight(e)});
+        }
+        return CSRGraph(V, reversed, true);
+    }
+};
+
+// Edge-list text: one "u v [weight]" per line, '#' or '%' starts a comment
+// line. Returns the number of fields read (0 for a blank or comment line),
+// or -1 for a malformed line. A missing weight is 1.
+int parseEdgeLine(const char* line, Edge& e) {
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line == '#' || *line == '%' || *line == '\n' || *line == '\r' || *line == 0) return 0;
+    char* end;
+    long long field[3] = {0, 0, 1};
+    int n = 0;
+    while (n < 3) {
+        long long x = strtoll(line, &end, 10);
+        if (end == line) break;
+        field[n++] = x;
+        line = end;
+    }
+    while (*line == ' ' || *line == '\t' || *line == '\r' || *line == '\n') line++;
+    if (n < 2 || *line || field[0] < 0 || field[1] < 0 || field[0] >= INT_MAX || field[1] >= INT_MAX ||
+        field[2] < 0 || field[2] > INT_MAX) {
+        return -1;
+    }
+    e = {(int)field[0], (int)field[1], (int)field[2]};
+    return n;
+}
+
+// Read a whole edge-list text file into memory. V becomes max id + 1.
+bool readEdgeList(const string& path, vector<Edge>& edges, int& V) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+    char* line = nullptr;  // getline grows it, so long lines are never split
+    size_t lineCap = 0;
+    Edge e;
+    bool ok = true;
+    V = 0;
+    while (ok && getline(&line, &lineCap, f) != -1) {
+        int fields = parseEdgeLine(line, e);
+        ok = fields >= 0;
+        if (fields > 0) {
+            edges.push_back(e);
+            V = max(V, max(e.u, e.v) + 1);
+        }
+    }
+    free(line);
+    fclose(f);
+    return ok;
+}
+
+bool writeEdgeList(const string& path, const vector<Edge>& edges) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    for (const Edge& e : edges) fprintf(f, "%d %d %d\n", e.u, e.v, e.weight);
+    return fclose(f) == 0;
+}
+
+// Stream an edge-list text file into the binary CSR format without holding
+// the edges in memory: pass 1 counts degrees, then the output file is
+// allocated and mapped, and pass 2 scatters each arc straight into its final
+// slot. posix_fallocate reserves the blocks up front, so a full disk fails
+// the conversion instead of raising SIGBUS on a store into a sparse mapping.
+// Memory is O(V) for the degree cursors. The file is weighted only if some
+// line carries a weight.
+bool convertEdgeList(const string& textPath, const string& csrPath, bool directed) {
+    FILE* in = fopen(textPath.c_str(), "r");
+    if (!in) return false;
+    char* line = nullptr;
+    size_t lineCap = 0;
+    Edge e;
+    vector<long long> cursor;  // Degrees, then next free slot per vertex
+    bool weighted = false, ok = true;
+    int maxW = 0, V = 0;
+    long long arcs = 0;
+    while (ok && getline(&line, &lineCap, in) != -1) {
+        int fields = parseEdgeLine(line, e);
+        ok = fields >= 0;
+        if (fields <= 0) continue;
+        size_t need = max(e.u, e.v) + 1;
+        if (cursor.size() < need) cursor.resize(max(need, cursor.size() * 2), 0);
+        V = max(V, (int)need);
+        cursor[e.u]++;
+        if (!directed) cursor[e.v]++;
+        arcs += directed ? 1 : 2;
+        weighted |= fields == 3;
+        maxW = max(maxW, e.weight);
+    }
+    cursor.resize(V);
+
+    CSRFileHeader h;
+    h.flags = (directed ? CSRFileHeader::DIRECTED : 0u) | (weighted ? CSRFileHeader::WEIGHTED : 0u) |
+              CSRFileHeader::CHECKSUMS;
+    h.vertices = V;
+    h.arcs = arcs;
+    h.maxWeight = weighted ? maxW : 1;
+    h.computeLayout();
+
+    int fd = ok ? ::open(csrPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : -1;
+    void* p = MAP_FAILED;
+    if (fd >= 0 && posix_fallocate(fd, 0, h.fileBytes) == 0) {
+        p = mmap(nullptr, h.fileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (fd >= 0) ::close(fd);
+    if (p == MAP_FAILED) {
+        free(line);
+        fclose(in);
+        return false;
+    }
+    char* base = (char*)p;
+    long long* offsets = (long long*)(base + h.offsetsPos);
+    int* targets = (int*)(base + h.targetsPos);
+    int* weights = (int*)(base + h.weightsPos);
+    offsets[0] = 0;
+    for (int u = 0; u < V; u++) {
+        offsets[u + 1] = offsets[u] + cursor[u];
+        cursor[u] = offsets[u];
+    }
+
+    rewind(in);
+    while (getline(&line, &lineCap, in) != -1) {
+        if (parseEdgeLine(line, e) <= 0) continue;
+        long long slot = cursor[e.u]++;
+        targets[slot] = e.v;
+        if (weighted) weights[slot] = e.weight;
+        if (!directed) {
+            slot = cursor[e.v]++;
+            targets[slot] = e.u;
+            if (weighted) weights[slot] = e.weight;
+        }
+    }
+    free(line);
+    fclose(in);
+
+    h.sectionChecksums[0] = checksum64(offsets, (V + 1) * sizeof(long long));
+    h.sectionChecksums[1] = checksum64(targets, arcs * sizeof(int));
+    if (weighted) h.sectionChecksums[2] = checksum64(weights, arcs * sizeof(int));
+    h.headerChecksum = checksum64(&h, offsetof(CSRFileHeader, headerChecksum));
+    memcpy(base, &h, sizeof(h));
+    ok = msync(p, h.fileBytes, MS_SYNC) == 0;
+    munmap(p, h.fileBytes);
+    return ok;
+}
+
+// Random graph generator: m edges with uniform endpoints, weights 1..maxWeight
+vector<Edge> randomEdges(int V, long long m, int maxWeight, uint64_t seed) {
+    vector<Edge> edges(m);
+    uint64_t x = seed | 1;
+    auto next = [&] {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        return x;
+    };
+    for (auto& e : edges) {
+        e.u = next() % V;
+        e.v = next() % V;
+        e.weight = 1 + next() % maxWeight;
+    }
+    return edges;
+}
+
+// R-MAT generator (Graph500 style): 2^scale vertices, edgeFactor * 2^scale edges.
+// Each edge picks one quadrant of the adjacency matrix per bit with
+// probabilities a, b, c, 1-a-b-c, giving a skewed, power-law degree distribution.
+vector<Edge> rmatEdges(int scale, int edgeFactor, int maxWeight, uint64_t seed,
+                       double a = 0.57, double b = 0.19, double c = 0.19) {
+    vector<Edge> edges((long long)edgeFactor << scale);
+    uint64_t x = seed | 1;
+    auto next = [&] {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        return x;
+    };
+    for (auto& e : edges) {
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            double r = (next() >> 11) * 0x1.0p-53;
+            if (r >= a + b + c) { u |= 1 << bit; v |= 1 << bit; }
+            else if (r >= a + b) u |= 1 << bit;
+            else if (r >= a) v |= 1 << bit;
+        }
+        e.u = u;
+        e.v = v;
+        e.weight = 1 + next() % maxWeight;
+    }
+    return edges;
+}
+
+// Road-network-like generator: rows x cols grid, 4-neighbor edges, weights 1..maxWeight
+vector<Edge> gridEdges(int rows, int cols, int maxWeight, uint64_t seed) {
+    vector<Edge> edges;
+    edges.reserve(2LL * rows * cols);
+    uint64_t x = seed | 1;
+    auto next = [&] {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        return x;
+    };
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int u = r * cols + c;
+            if (c + 1 < cols) edges.push_back({u, u + 1, (int)(1 + next() % maxWeight)});
+            if (r + 1 < rows) edges.push_back({u, u + cols, (int)(1 + next() % maxWeight)});
+        }
+    }
+    return edges;
+}
+
+// Parallel helpers
+int defaultThreads() {
+    unsigned n = thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// Persistent worker threads for parallelFor. Workers start on first use and
+// sleep on a condition variable between jobs, so the per-level, per-round
+// and per-phase calls of the parallel algorithms pay one wake-up each
+// instead of creating and joining threads every time.
+class WorkerPool {
+private:
+    mutex dispatchLock;  // One job at a time
+    mutex lock;
+    condition_variable wake, done;
+    vector<thread> workers;
+    void (*job)(void*, int) = nullptr;
+    void* context = nullptr;
+    int active = 0;      // Workers with tid <= active run the current job
+    int pending = 0;     // Of those, how many have not finished yet
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void loop(int tid) {
+        inWorker = true;
+        uint64_t seen = 0;
+        unique_lock<mutex> guard(lock);
+        for (;;) {
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (tid > active) continue;
+            guard.unlock();
+            job(context, tid);
+            guard.lock();
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+public:
+    inline static thread_local bool inWorker = false;  // Nested calls run inline
+
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    // Runs f(tid) for tid = 0..helpers: tid 0 on the calling thread, the
+    // rest on pool workers. Returns once all of them have finished.
+    template<typename F>
+    void run(int helpers, F& f) {
+        lock_guard<mutex> dispatch(dispatchLock);
+        {
+            lock_guard<mutex> guard(lock);
+            while ((int)workers.size() < helpers) {
+                int tid = workers.size() + 1;
+                workers.emplace_back([this, tid] { loop(tid); });
+            }
+            job = [](void* c, int tid) { (*(F*)c)(tid); };
+            context = &f;
+            active = pending = helpers;
+            generation++;
+        }
+        wake.notify_all();
+        inWorker = true;
+        f(0);
+        inWorker = false;
+        unique_lock<mutex> guard(lock);
+        done.wait(guard, [&] { return pending == 0; });
+    }
+};
+
+// Calls body(begin, end, tid) over [0, n) in chunks of `grain`, handed out
+// dynamically to `threads` threads from the WorkerPool. Runs inline when
+// there is only one chunk or when called from inside another parallelFor.
+template<typename F>
+void parallelFor(long long n, int threads, long long grain, F body) {
+    if (threads <= 1 || n <= grain || WorkerPool::inWorker) {
+        if (n > 0) body(0LL, n, 0);
+        return;
+    }
+    threads = (int)min<long long>(threads, (n + grain - 1) / grain);
+    atomic<long long> next(0);
+    auto worker = [&](int tid) {
+        for (;;) {
+            long long begin = next.fetch_add(grain);
+            if (begin >= n) break;
+            body(begin, min(n, begin + grain), tid);
+        }
+    };
+    WorkerPool::instance().run(threads - 1, worker);
+}
+
+// Direction-optimizing parallel BFS (Beamer et al.)
+// Top-down steps expand the frontier queue and claim children with CAS.
+// When the frontier's arcs outnumber the unexplored arcs / ALPHA, it switches
+// to bottom-up steps: every unvisited vertex scans its in-arcs for a parent in
+// the frontier bitmap and stops at the first hit. Once the frontier shrinks
+// below V / BETA it switches back.
+struct BFSResult {
+    vector<int> dist;    // INT_MAX if unreachable
+    vector<int> parent;  // -1 if unreachable, src for src
+    int topDownSteps = 0;
+    int bottomUpSteps = 0;
+};
+
+BFSResult parallelBFS(const CSRGraph& g, int src, int threads = defaultThreads(),
+                      const CSRGraph* reverse = nullptr) {
+    const int ALPHA = 14, BETA = 24;
+    int V = g.numVertices();
+    CSRGraph transposed = (g.isDirected() && !reverse) ? g.transpose() : CSRGraph(0, {});
+    const CSRGraph& in = g.isDirected() ? (reverse ? *reverse : transposed) : g;
+
+    BFSResult r;
+    r.dist.assign(V, INT_MAX);
+    vector<atomic<int>> parent(V);
+    for (auto& p : parent) p.store(-1, memory_order_relaxed);
+
+    long long words = (V + 63) / 64;
+    vector<uint64_t> frontBits(words), nextBits(words);
+    vector<int> frontier = {src};
+    vector<vector<int>> local(max(threads, 1));
+    vector<long long> localCount(max(threads, 1)), localArcs(max(threads, 1));
+
+    parent[src] = src;
+    r.dist[src] = 0;
+    long long frontierArcs = g.degree(src);
+    long long unexploredArcs = g.numArcs() - frontierArcs;
+    long long frontierSize = 1;
+    bool bitmapFrontier = false;
+
+    for (int level = 0; frontierSize > 0; level++) {
+        if (!bitmapFrontier && frontierArcs > unexploredArcs / ALPHA) {
+            // Queue -> bitmap
+            fill(frontBits.begin(), frontBits.end(), 0);
+            for (int u : frontier) frontBits[u >> 6] |= 1ULL << (u & 63);
+            bitmapFrontier = true;
+        } else if (bitmapFrontier && frontierSize < V / BETA) {
+            // Bitmap -> queue
+            frontier.clear();
+            for (long long w = 0; w < words; w++) {
+                for (uint64_t bits = frontBits[w]; bits; bits &= bits - 1) {
+                    frontier.push_back(w * 64 + __builtin_ctzll(bits));
+                }
+            }
+            bitmapFrontier = false;
+        }
+
+        for (auto& l : local) l.clear();
+        fill(localCount.begin(), localCount.end(), 0);
+        fill(localArcs.begin(), localArcs.end(), 0);
+
+        if (bitmapFrontier) {
+            r.bottomUpSteps++;
+            // Each chunk owns whole 64-vertex words, so no atomics are needed
+            parallelFor(words, threads, 64, [&](long long begin, long long end, int tid) {
+                for (long long w = begin; w < end; w++) {
+                    uint64_t bits = 0;
+                    int last = (int)min<long long>(V, w * 64 + 64);
+                    for (int v = w * 64; v < last; v++) {
+                        if (parent[v].load(memory_order_relaxed) != -1) continue;
+                        for (long long e = in.edgeBegin(v); e < in.edgeEnd(v); e++) {
+                            int u = in.target(e);
+                            if (frontBits[u >> 6] >> (u & 63) & 1) {
+                                parent[v].store(u, memory_order_relaxed);
+                                r.dist[v] = level + 1;
+                                bits |= 1ULL << (v & 63);
+                                localCount[tid]++;
+                                localArcs[tid] += g.degree(v);
+                                break;
+                            }
+                        }
+                    }
+                    nextBits[w] = bits;
+                }
+            });
+            swap(frontBits, nextBits);
+        } else {
+            r.topDownSteps++;
+            parallelFor(frontier.size(), threads, 256, [&](long long begin, long long end, int tid) {
+                for (long long i = begin; i < end; i++) {
+                    int u = frontier[i];
+                    for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                        int v = g.target(e);
+                        int expected = -1;
+                        if (parent[v].load(memory_order_relaxed) == -1 &&
+                            parent[v].compare_exchange_strong(expected, u, memory_order_relaxed)) {
+                            r.dist[v] = level + 1;
+                            local[tid].push_back(v);
+                            localCount[tid]++;
+                            localArcs[tid] += g.degree(v);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for (auto& l : local) frontier.insert(frontier.end(), l.begin(), l.end());
+        }
+
+        frontierSize = 0;
+        frontierArcs = 0;
+        for (size_t t = 0; t < local.size(); t++) {
+            frontierSize += localCount[t];
+            frontierArcs += localArcs[t];
+        }
+        unexploredArcs -= frontierArcs;
+    }
+
+    r.parent.resize(V);
+    for (int v = 0; v < V; v++) r.parent[v] = parent[v].load(memory_order_relaxed);
+    return r;
+}
+
+// Delta-stepping SSSP (Meyer & Sanders) - parallel Dijkstra relaxation
+// Vertices live in buckets of width delta by tentative distance. The lowest
+// non-empty bucket is drained in parallel rounds that relax light arcs
+// (weight <= delta), which can refill the same bucket. Once it is empty,
+// heavy arcs of everything settled in it are relaxed once. delta = 1 behaves
+// like Dijkstra, a huge delta like Bellman-Ford; delta <= 0 picks
+// maxWeight / average degree. Returns the same dist as dijkstra().
+// While bucket i is processed every queued distance lies in
+// [i * delta, (i + 1) * delta + maxWeight), so the buckets form a ring of
+// ceil(maxWeight / delta) + 1 slots instead of one per maxDist / delta.
+vector<int> deltaStepping(const CSRGraph& g, int src, int delta = 0, int threads = defaultThreads()) {
+    int V = g.numVertices();
+    if (delta <= 0) delta = max<long long>(1, g.maxWeight() * (long long)V / max(1LL, g.numArcs()));
+    int T = max(threads, 1);
+    size_t ring = ((long long)g.maxWeight() + delta - 1) / delta + 1;
+
+    vector<atomic<int>> dist(V);
+    for (auto& d : dist) d.store(INT_MAX, memory_order_relaxed);
+    // buckets[tid][i % ring]: thread-local, no locking
+    vector<vector<vector<int>>> buckets(T, vector<vector<int>>(ring));
+
+    auto relax = [&](int v, int nd, int tid) {
+        int old = dist[v].load(memory_order_relaxed);
+        while (nd < old) {
+            if (dist[v].compare_exchange_weak(old, nd, memory_order_relaxed)) {
+                buckets[tid][(size_t)(nd / delta) % ring].push_back(v);
+                return;
+            }
+        }
+    };
+
+    dist[src] = 0;
+    buckets[0][0].push_back(src);
+
+    vector<int> frontier, settled;
+    vector<int> settledIn(V, -1);  // Last bucket v was added to `settled` from
+    for (size_t i = 0;; i++) {
+        size_t next = SIZE_MAX;
+        for (size_t j = i; j < i + ring && next == SIZE_MAX; j++) {
+            for (auto& b : buckets) {
+                if (!b[j % ring].empty()) {
+                    next = j;
+                    break;
+                }
+            }
+        }
+        if (next == SIZE_MAX) break;
+        i = next;
+
+        // Light phase: repeat until bucket i stays empty
+        settled.clear();
+        for (;;) {
+            frontier.clear();
+            for (auto& b : buckets) {
+                for (int v : b[i % ring]) {
+                    // Stale entry: v was re-relaxed into a lower bucket
+                    if ((size_t)(dist[v].load(memory_order_relaxed) / delta) != i) continue;
+                    frontier.push_back(v);
+                    if (settledIn[v] != (int)i) {
+                        settledIn[v] = i;
+                        settled.push_back(v);
+                    }
+                }
+                b[i % ring].clear();
+            }
+            if (frontier.empty()) break;
+            parallelFor(frontier.size(), T, 256, [&](long long begin, long long end, int tid) {
+                for (long long k = begin; k < end; k++) {
+                    int u = frontier[k];
+                    int d = dist[u].load(memory_order_relaxed);
+                    for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                        if (g.weight(e) <= delta) relax(g.target(e), d + g.weight(e), tid);
+                    }
+                }
+            });
+        }
+
+        // Heavy phase: distances in bucket i are final now
+        parallelFor(settled.size(), T, 256, [&](long long begin, long long end, int tid) {
+            for (long long k = begin; k < end; k++) {
+                int u = settled[k];
+                int d = dist[u].load(memory_order_relaxed);
+                for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                    if (g.weight(e) > delta) relax(g.target(e), d + g.weight(e), tid);
+                }
+            }
+        });
+    }
+
+    vector<int> result(V);
+    for (int v = 0; v < V; v++) result[v] = dist[v].load(memory_order_relaxed);
+    return result;
+}
+
+// Integer-weight Dijkstra queues
+// All three support push(v, key) as insert-or-decrease-key and pop() -> {key, v},
+// and rely on Dijkstra's monotonicity: popped keys never decrease.
+
+// Binary heap with lazy deletion (what dijkstra() uses), tracking its peak size
+class BinaryHeapQueue {
+private:
+    priority_queue<pair<int,int>, vector<pair<int,int>>, greater<pair<int,int>>> pq;
+    vector<int> key;
+    size_t peak = 0;
+
+public:
+    BinaryHeapQueue(int V) : key(V, INT_MAX) {}
+
+    bool empty() {
+        while (!pq.empty() && pq.top().first != key[pq.top().second]) pq.pop();  // Stale duplicates
+        return pq.empty();
+    }
+
+    void push(int v, int k) {
+        key[v] = k;
+        pq.push({k, v});
+        peak = max(peak, pq.size());
+    }
+
+    pair<int,int> pop() {
+        auto top = pq.top();
+        pq.pop();
+        key[top.second] = -1;
+        return top;
+    }
+
+    size_t memoryBytes() const { return peak * sizeof(pair<int,int>) + key.size() * sizeof(int); }
+};
+
+// Dial's buckets: maxWeight + 1 circular buckets of intrusive doubly linked
+// lists. Every queued key lies in [cur, cur + maxWeight], so key % buckets
+// never collides. Decrease-key is an O(1) unlink + relink, without duplicates.
+// pop() scans empty buckets, O(max distance) in total.
+class DialQueue {
+private:
+    int buckets;
+    vector<int> head, next, prev, key;  // key -1: not queued
+    int cur = 0;
+    long long count = 0;
+
+    void unlink(int v) {
+        if (prev[v] != -1) next[prev[v]] = next[v];
+        else head[key[v] % buckets] = next[v];
+        if (next[v] != -1) prev[next[v]] = prev[v];
+        count--;
+    }
+
+public:
+    DialQueue(int V, int maxWeight)
+        : buckets(maxWeight + 1), head(buckets, -1), next(V), prev(V), key(V, -1) {}
+
+    bool empty() const { return count == 0; }
+
+    void push(int v, int k) {
+        if (key[v] != -1) unlink(v);
+        key[v] = k;
+        int b = k % buckets;
+        prev[v] = -1;
+        next[v] = head[b];
+        if (head[b] != -1) prev[head[b]] = v;
+        head[b] = v;
+        count++;
+    }
+
+    pair<int,int> pop() {
+        while (head[cur % buckets] == -1) cur++;
+        int v = head[cur % buckets];
+        unlink(v);
+        key[v] = -1;
+        return {cur, v};
+    }
+
+    size_t memoryBytes() const { return (head.size() + next.size() + prev.size() + key.size()) * sizeof(int); }
+};
+
+// Radix heap: bucket b > 0 holds keys whose highest bit differing from the
+// last popped key is bit b - 1; bucket 0 holds keys equal to it. pop() empties
+// bucket 0 or redistributes the first non-empty bucket around its minimum,
+// which moves every entry to a strictly lower bucket: O(log C) amortized
+// moves per vertex. Vertices record their slot, so decrease-key is a
+// swap-remove + insert and no duplicates are pushed.
+class RadixHeap {
+private:
+    vector<int> bucket[33];
+    vector<int> key, pos;
+    vector<signed char> bucketOf;  // -1: not queued
+    int last = 0;
+    long long count = 0;
+
+    void place(int v) {
+        unsigned diff = (unsigned)key[v] ^ (unsigned)last;
+        int b = diff ? 32 - __builtin_clz(diff) : 0;
+        bucketOf[v] = b;
+        pos[v] = bucket[b].size();
+        bucket[b].push_back(v);
+    }
+
+public:
+    RadixHeap(int V) : key(V), pos(V), bucketOf(V, -1) {}
+
+    bool empty() const { return count == 0; }
+
+    void push(int v, int k) {
+        if (bucketOf[v] != -1) {
+            vector<int>& b = bucket[bucketOf[v]];
+            int moved = b.back();
+            b[pos[v]] = moved;
+            pos[moved] = pos[v];
+            b.pop_back();
+        } else {
+            count++;
+        }
+        key[v] = k;
+        place(v);
+    }
+
+    pair<int,int> pop() {
+        if (bucket[0].empty()) {
+            int i = 1;
+            while (bucket[i].empty()) i++;
+            last = key[bucket[i][0]];
+            for (int v : bucket[i]) last = min(last, key[v]);
+            vector<int> moving;
+            moving.swap(bucket[i]);
+            for (int v : moving) place(v);
+            moving.clear();
+            bucket[i].swap(moving);  // Keep its capacity
+        }
+        int v = bucket[0].back();
+        bucket[0].pop_back();
+        bucketOf[v] = -1;
+        count--;
+        return {key[v], v};
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = (key.size() + pos.size()) * sizeof(int) + bucketOf.size();
+        for (auto& b : bucket) bytes += b.capacity() * sizeof(int);
+        return bytes;
+    }
+};
+
+template<typename Queue>
+vector<int> dijkstraWith(const CSRGraph& g, int src, Queue& pq) {
+    vector<int> dist(g.numVertices(), INT_MAX);
+    dist[src] = 0;
+    pq.push(src, 0);
+    while (!pq.empty()) {
+        auto [d, u] = pq.pop();
+        for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            int v = g.target(e);
+            if (d + g.weight(e) < dist[v]) {
+                dist[v] = d + g.weight(e);
+                pq.push(v, dist[v]);
+            }
+        }
+    }
+    return dist;
+}
+
+enum class DijkstraQueue { Auto, BinaryHeap, Dial, Radix };
+
+// Dial while the bucket ring stays small, radix heap beyond that
+const int DIAL_MAX_WEIGHT = 1 << 12;
+
+DijkstraQueue chooseQueue(const CSRGraph& g) {
+    return g.maxWeight() <= DIAL_MAX_WEIGHT ? DijkstraQueue::Dial : DijkstraQueue::Radix;
+}
+
+// Dijkstra for non-negative integer weights, queue picked from the weight range.
+// Same dist as dijkstra(); queueBytes receives the queue's memory footprint.
+vector<int> integerDijkstra(const CSRGraph& g, int src, DijkstraQueue queue = DijkstraQueue::Auto,
+                            size_t* queueBytes = nullptr) {
+    if (queue == DijkstraQueue::Auto) queue = chooseQueue(g);
+    vector<int> dist;
+    size_t bytes = 0;
+    if (queue == DijkstraQueue::Dial) {
+        DialQueue pq(g.numVertices(), g.maxWeight());
+        dist = dijkstraWith(g, src, pq);
+        bytes = pq.memoryBytes();
+    } else if (queue == DijkstraQueue::Radix) {
+        RadixHeap pq(g.numVertices());
+        dist = dijkstraWith(g, src, pq);
+        bytes = pq.memoryBytes();
+    } else {
+        BinaryHeapQueue pq(g.numVertices());
+        dist = dijkstraWith(g, src, pq);
+        bytes = pq.memoryBytes();
+    }
+    if (queueBytes) *queueBytes = bytes;
+    return dist;
+}
+
+// Point-to-point shortest paths
+struct PathQuery {
+    int dist;          // INT_MAX if t is unreachable
+    long long settled; // Vertices settled, both directions together
+};
+
+// Per-thread search state. dist[side][v] is valid only while stamp[side][v] == now,
+// so starting a query bumps `now` instead of refilling V entries.
+struct SearchScratch {
+    vector<int> dist[2];
+    vector<unsigned> stamp[2];
+    unsigned now = 0;
+    vector<pair<int,int>> heap[2];  // Min-heaps of {key, v}, capacity kept across queries
+
+    void reset(int V) {
+        if ((int)stamp[0].size() < V) {
+            for (int side = 0; side < 2; side++) {
+                dist[side].resize(V);
+                stamp[side].assign(V, 0);
+            }
+            now = 0;
+        }
+        if (++now == 0) {  // Wrapped around: old stamps could match again
+            for (auto& st : stamp) fill(st.begin(), st.end(), 0);
+            now = 1;
+        }
+        heap[0].clear();
+        heap[1].clear();
+    }
+
+    int get(int side, int v) const { return stamp[side][v] == now ? dist[side][v] : INT_MAX; }
+
+    void set(int side, int v, int d) {
+        stamp[side][v] = now;
+        dist[side][v] = d;
+    }
+
+    void push(int side, int key, int v) {
+        heap[side].push_back({key, v});
+        push_heap(heap[side].begin(), heap[side].end(), greater<pair<int,int>>());
+    }
+
+    pair<int,int> pop(int side) {
+        pop_heap(heap[side].begin(), heap[side].end(), greater<pair<int,int>>());
+        auto top = heap[side].back();
+        heap[side].pop_back();
+        return top;
+    }
+};
+
+// One scratch per thread, shared by all searches that run on it
+SearchScratch& threadScratch() {
+    thread_local SearchScratch s;
+    return s;
+}
+
+// Source-target queries over a CSRGraph. Queries are const and use
+// thread-local scratch, so one engine can serve many threads at once.
+class PointToPointEngine {
+private:
+    const CSRGraph& g;
+    CSRGraph reversed;  // In-arcs for the backward search; empty if undirected
+
+    const CSRGraph& arcs(int side) const { return side == 1 && g.isDirected() ? reversed : g; }
+
+public:
+    PointToPointEngine(const CSRGraph& graph)
+        : g(graph), reversed(graph.isDirected() ? graph.transpose() : CSRGraph(0, {})) {}
+
+    // Plain Dijkstra that stops once t is settled
+    PathQuery dijkstra(int s, int t) const {
+        SearchScratch& sc = threadScratch();
+        sc.reset(g.numVertices());
+        sc.set(0, s, 0);
+        sc.push(0, 0, s);
+        long long settled = 0;
+        while (!sc.heap[0].empty()) {
+            auto [d, u] = sc.pop(0);
+            if (d > sc.get(0, u)) continue;
+            settled++;
+            if (u == t) return {d, settled};
+            for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                int v = g.target(e);
+                if (d + g.weight(e) < sc.get(0, v)) {
+                    sc.set(0, v, d + g.weight(e));
+                    sc.push(0, d + g.weight(e), v);
+                }
+            }
+        }
+        return {INT_MAX, settled};
+    }
+
+    // Bidirectional Dijkstra: forward from s and backward from t, expanding
+    // the smaller queue. Every relaxation that reaches a vertex labeled by
+    // the other side is a candidate path; stop once the two queue minimums
+    // add up to at least the best candidate.
+    PathQuery bidirectional(int s, int t) const {
+        SearchScratch& sc = threadScratch();
+        sc.reset(g.numVertices());
+        sc.set(0, s, 0);
+        sc.set(1, t, 0);
+        sc.push(0, 0, s);
+        sc.push(1, 0, t);
+        int best = s == t ? 0 : INT_MAX;
+        long long settled = 0;
+        while (!sc.heap[0].empty() && !sc.heap[1].empty()) {
+            if ((long long)sc.heap[0].front().first + sc.heap[1].front().first >= best) break;
+            int side = sc.heap[0].size() <= sc.heap[1].size() ? 0 : 1;
+            auto [d, u] = sc.pop(side);
+            if (d > sc.get(side, u)) continue;
+            settled++;
+            const CSRGraph& a = arcs(side);
+            for (long long e = a.edgeBegin(u); e < a.edgeEnd(u); e++) {
+                int v = a.target(e);
+                int nd = d + a.weight(e);
+                if (nd >= sc.get(side, v)) continue;
+                sc.set(side, v, nd);
+                sc.push(side, nd, v);
+                int other = sc.get(1 - side, v);
+                if (other != INT_MAX && (long long)nd + other < best) best = nd + other;
+            }
+        }
+        return {best, settled};
+    }
+
+    // A*: Dijkstra ordered by dist + h(v, t). h must be admissible (never
+    // overestimate); vertices are reopened when their distance improves, so
+    // it need not be consistent. h values are cached in the backward slot.
+    template<typename Heuristic>
+    PathQuery astar(int s, int t, Heuristic h) const {
+        SearchScratch& sc = threadScratch();
+        sc.reset(g.numVertices());
+        auto cachedH = [&](int v) {
+            int hv = sc.get(1, v);
+            if (hv == INT_MAX) {
+                hv = h(v, t);
+                sc.set(1, v, hv);
+            }
+            return hv;
+        };
+        sc.set(0, s, 0);
+        sc.push(0, cachedH(s), s);
+        long long settled = 0;
+        while (!sc.heap[0].empty()) {
+            auto [f, u] = sc.pop(0);
+            int d = sc.get(0, u);
+            if (f > d + cachedH(u)) continue;
+            settled++;
+            if (u == t) return {d, settled};
+            for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                int v = g.target(e);
+                int nd = d + g.weight(e);
+                if (nd < sc.get(0, v)) {
+                    sc.set(0, v, nd);
+                    sc.push(0, nd + cachedH(v), v);
+                }
+            }
+        }
+        return {INT_MAX, settled};
+    }
+};
+
+// ALT heuristic (A*, Landmarks, Triangle inequality)
+// With exact distances to and from a few landmarks L:
+//   d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+// Landmarks are picked farthest-first, so they sit on the graph's periphery.
+class LandmarkHeuristic {
+private:
+    vector<vector<int>> from, to;  // from[i][v] = d(L_i, v), to[i][v] = d(v, L_i)
+
+public:
+    LandmarkHeuristic(const CSRGraph& g, int count, int first = 0) {
+        CSRGraph reversed = g.isDirected() ? g.transpose() : CSRGraph(0, {});
+        vector<long long> closest(g.numVertices(), LLONG_MAX);  // Min over chosen landmarks
+        int landmark = first;
+        for (int i = 0; i < count; i++) {
+            from.push_back(integerDijkstra(g, landmark));
+            to.push_back(g.isDirected() ? integerDijkstra(reversed, landmark) : from.back());
+            for (int v = 0; v < g.numVertices(); v++) {
+                if (from.back()[v] != INT_MAX) closest[v] = min<long long>(closest[v], from.back()[v]);
+            }
+            landmark = max_element(closest.begin(), closest.end(), [](long long a, long long b) {
+                return (a == LLONG_MAX ? -1 : a) < (b == LLONG_MAX ? -1 : b);
+            }) - closest.begin();
+        }
+    }
+
+    int operator()(int v, int t) const {
+        int bound = 0;
+        for (size_t i = 0; i < from.size(); i++) {
+            if (from[i][t] != INT_MAX && from[i][v] != INT_MAX) bound = max(bound, from[i][t] - from[i][v]);
+            if (to[i][v] != INT_MAX && to[i][t] != INT_MAX) bound = max(bound, to[i][v] - to[i][t]);
+        }
+        return bound;
+    }
+
+    size_t memoryBytes() const { return 2 * from.size() * (from.empty() ? 0 : from[0].size()) * sizeof(int); }
+};
+
+// Contraction Hierarchies (Geisberger et al.)
+// Preprocessing removes ("contracts") vertices one at a time, cheapest first.
+// Removing v adds a shortcut u -> w for every in/out neighbor pair whose
+// shortest path went through v, which a bounded local Dijkstra (the witness
+// search) fails to beat; distances among the remaining vertices stay exact.
+// The contraction order is the vertex rank. Each vertex keeps only its arcs
+// to higher-ranked vertices, and a query runs a bidirectional Dijkstra that
+// only moves upward - a few hundred settled vertices instead of millions.
+class ContractionHierarchy {
+private:
+    int V = 0;
+    long long shortcuts = 0;
+    vector<int> rank;  // Contraction order
+    // Upward graphs in CSR form: side 0 = out-arcs u -> w, side 1 = reversed
+    // in-arcs (w -> u stored at u), both only toward higher rank
+    vector<long long> offsets[2];
+    vector<int> targets[2], weights[2];
+
+    static const uint32_t FILE_MAGIC = 0x31484343;  // "CCH1"
+    static const uint32_t FILE_VERSION = 2;         // 1 had no version field
+
+public:
+    ContractionHierarchy() {
+        offsets[0].assign(1, 0);  // Valid for V = 0, so an empty hierarchy saves and loads
+        offsets[1].assign(1, 0);
+    }
+
+    // witnessLimit bounds the vertices each witness search may settle; lower
+    // is faster to build but may add unnecessary (still correct) shortcuts
+    ContractionHierarchy(const CSRGraph& g, int witnessLimit = 500) : V(g.numVertices()), rank(V, -1) {
+        // Overlay of the remaining graph: adj[0][v] = out-arcs, adj[1][v] =
+        // in-arcs. Each arc knows the position of its twin in the other list,
+        // and arcIndex finds u -> w in adj[0][u], so merging a parallel arc and
+        // unlinking a contracted vertex never scan a hub's whole list.
+        struct Arc { int to, weight, twin; };
+        vector<vector<Arc>> adj[2];
+        adj[0].resize(V);
+        adj[1].resize(V);
+        unordered_map<uint64_t, int> arcIndex;
+        arcIndex.reserve(g.numArcs());
+        auto arcKey = [](int u, int w) { return (uint64_t)(uint32_t)u << 32 | (uint32_t)w; };
+        auto addArc = [&](int u, int w, int weight) {  // Keeps the lighter of parallel arcs
+            auto it = arcIndex.find(arcKey(u, w));
+            if (it != arcIndex.end()) {
+                Arc& a = adj[0][u][it->second];
+                if (weight < a.weight) {
+                    a.weight = weight;
+                    adj[1][w][a.twin].weight = weight;
+                }
+                return false;
+            }
+            arcIndex.emplace(arcKey(u, w), (int)adj[0][u].size());
+            adj[0][u].push_back({w, weight, (int)adj[1][w].size()});
+            adj[1][w].push_back({u, weight, (int)adj[0][u].size() - 1});
+            return true;
+        };
+        // Swap-remove adj[side][x][i] and repoint the moved arc's twin
+        auto unlinkAt = [&](int side, int x, int i) {
+            auto& list = adj[side][x];
+            list[i] = list.back();
+            list.pop_back();
+            if (i == (int)list.size()) return;
+            adj[1 - side][list[i].to][list[i].twin].twin = i;
+            if (side == 0) arcIndex[arcKey(x, list[i].to)] = i;
+        };
+        for (int u = 0; u < V; u++) {
+            for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                if (g.target(e) != u) addArc(u, g.target(e), g.weight(e));
+            }
+        }
+
+        vector<Edge> added;
+        vector<pair<int, int>> outs;  // {weight, w} for v's out-arcs, heaviest first
+        auto findShortcuts = [&](int v, int limit, long long scanLimit) {
+            added.clear();
+            outs.clear();
+            for (const Arc& a : adj[0][v]) outs.push_back({a.weight, a.to});
+            sort(outs.begin(), outs.end(), greater<pair<int, int>>());
+            for (const Arc& in : adj[1][v]) {
+                // Witness search from u that avoids v. Side 1 holds weight(v, w)
+                // for each target w not witnessed yet, -1 once it is: a target
+                // is witnessed as soon as its tentative distance is within
+                // wu + weight(v, w), and the search stops past wu + the
+                // heaviest unwitnessed target, so it rarely settles them all.
+                int u = in.to, wu = in.weight;
+                SearchScratch& sc = threadScratch();
+                sc.reset(V);
+                int remaining = 0;
+                for (auto [weight, w] : outs) {
+                    if (w != u) {
+                        sc.set(1, w, weight);
+                        remaining++;
+                    }
+                }
+                auto reach = [&](int y, int d) {
+                    sc.set(0, y, d);
+                    int target = sc.get(1, y);
+                    if (target != INT_MAX && target >= 0 && d <= wu + target) {
+                        sc.set(1, y, -1);
+                        remaining--;
+                    }
+                };
+                reach(u, 0);
+                sc.push(0, 0, u);
+                size_t heaviest = 0;
+                int settled = 0;
+                long long scanned = 0;
+                while (!sc.heap[0].empty() && remaining > 0) {
+                    while (outs[heaviest].second == u || sc.get(1, outs[heaviest].second) < 0) heaviest++;
+                    int bound = wu + outs[heaviest].first;
+                    auto [d, x] = sc.pop(0);
+                    if (d > sc.get(0, x)) continue;
+                    if (d > bound || ++settled > limit || scanned > scanLimit) break;
+                    scanned += adj[0][x].size();
+                    for (const Arc& a : adj[0][x]) {
+                        int nd = d + a.weight;
+                        if (a.to != v && nd <= bound && nd < sc.get(0, a.to)) {
+                            reach(a.to, nd);
+                            sc.push(0, nd, a.to);
+                        }
+                    }
+                }
+                for (auto [weight, w] : outs) {
+                    if (w != u && sc.get(0, w) > wu + weight) added.push_back({u, w, wu + weight});
+                }
+            }
+        };
+        // Edge difference plus contracted neighbors, which spreads contraction
+        // evenly. Simulated with much smaller searches than the real run (20
+        // settled vertices, about 200 scanned arcs), so on power-law graphs a
+        // hub's long arc list does not dominate every estimate near it.
+        vector<int> contractedNeighbors(V, 0);
+        auto priority = [&](int v) {
+            findShortcuts(v, min(witnessLimit, 20), 200);
+            return (int)added.size() - (int)(adj[0][v].size() + adj[1][v].size()) + contractedNeighbors[v];
+        };
+
+        // Priorities are cached. Contracting v only changes the overlay
+        // around its neighbors, so only they are marked dirty, and a dirty
+        // vertex is re-evaluated when it reaches the top of the queue (going
+        // back in if it got costlier than the next one). Hubs sit deep in the
+        // queue, so their expensive simulations are not redone after every
+        // neighbor's contraction.
+        vector<int> cached(V);
+        vector<char> dirty(V, 0);
+        priority_queue<pair<int,int>, vector<pair<int,int>>, greater<pair<int,int>>> pq;
+        for (int v = 0; v < V; v++) pq.push({cached[v] = priority(v), v});
+        vector<vector<pair<int, int>>> up[2];
+        up[0].resize(V);
+        up[1].resize(V);
+        vector<int> neighbors;
+        vector<int> seen(V, -1);  // Last contraction that listed v in `neighbors`
+        int order = 0;
+        while (!pq.empty()) {
+            auto [p, v] = pq.top();
+            pq.pop();
+            if (rank[v] >= 0 || p != cached[v]) continue;
+            if (dirty[v]) {
+                dirty[v] = 0;
+                cached[v] = priority(v);
+                if (!pq.empty() && cached[v] > pq.top().first) {
+                    pq.push({cached[v], v});
+                    continue;
+                }
+            }
+
+            findShortcuts(v, witnessLimit, LLONG_MAX);
+            rank[v] = order;
+            neighbors.clear();
+            for (int side = 0; side < 2; side++) {
+                for (const Arc& a : adj[side][v]) {
+                    unlinkAt(1 - side, a.to, a.twin);
+                    arcIndex.erase(side == 0 ? arcKey(v, a.to) : arcKey(a.to, v));
+                    up[side][v].push_back({a.to, a.weight});  // Every remaining neighbor ranks higher
+                    if (seen[a.to] != order) {
+                        seen[a.to] = order;
+                        neighbors.push_back(a.to);
+                    }
+                }
+                vector<Arc>().swap(adj[side][v]);
+            }
+            for (const Edge& e : added) shortcuts += addArc(e.u, e.v, e.weight);
+            for (int w : neighbors) {
+                contractedNeighbors[w]++;
+                dirty[w] = 1;
+            }
+            order++;
+        }
+
+        for (int side = 0; side < 2; side++) {
+            offsets[side].assign(V + 1, 0);
+            for (int v = 0; v < V; v++) offsets[side][v + 1] = offsets[side][v] + up[side][v].size();
+            targets[side].reserve(offsets[side][V]);
+            weights[side].reserve(offsets[side][V]);
+            for (int v = 0; v < V; v++) {
+                for (auto [w, weight] : up[side][v]) {
+                    targets[side].push_back(w);
+                    weights[side].push_back(weight);
+                }
+                vector<pair<int, int>>().swap(up[side][v]);
+            }
+        }
+    }
+
+    int numVertices() const { return V; }
+    long long numShortcuts() const { return shortcuts; }
+    int vertexRank(int v) const { return rank[v]; }
+
+    size_t memoryBytes() const {
+        size_t bytes = rank.size() * sizeof(int);
+        for (int side = 0; side < 2; side++) {
+            bytes += offsets[side].size() * sizeof(long long) + (targets[side].size() + weights[side].size()) * sizeof(int);
+        }
+        return bytes;
+    }
+
+    // Upward bidirectional Dijkstra. A side stops once its queue minimum
+    // reaches the best meeting distance; the meeting vertex is the highest
+    // ranked vertex on the shortest path.
+    PathQuery query(int s, int t) const {
+        SearchScratch& sc = threadScratch();
+        sc.reset(V);
+        sc.set(0, s, 0);
+        sc.set(1, t, 0);
+        sc.push(0, 0, s);
+        sc.push(1, 0, t);
+        int best = INT_MAX;
+        long long settled = 0;
+        for (;;) {
+            bool active[2];
+            for (int side = 0; side < 2; side++) active[side] = !sc.heap[side].empty() && sc.heap[side].front().first < best;
+            if (!active[0] && !active[1]) break;
+            int side = !active[0] ? 1 : !active[1] ? 0 : sc.heap[0].front().first <= sc.heap[1].front().first ? 0 : 1;
+            auto [d, u] = sc.pop(side);
+            if (d > sc.get(side, u)) continue;
+            settled++;
+            int other = sc.get(1 - side, u);
+            if (other != INT_MAX) best = min(best, d + other);
+            for (long long e = offsets[side][u]; e < offsets[side][u + 1]; e++) {
+                int v = targets[side][e];
+                int nd = d + weights[side][e];
+                if (nd < sc.get(side, v)) {
+                    sc.set(side, v, nd);
+                    sc.push(side, nd, v);
+                }
+            }
+        }
+        return {best, settled};
+    }
+
+    // File layout (native endianness): magic, version, V, shortcuts, then
+    // rank[V] and, for each side, offsets[V + 1], targets[arcs], weights[arcs]
+    bool save(const string& path) const {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok = true;
+        auto write = [&](const void* data, size_t size, size_t count) {
+            if (count) ok = ok && fwrite(data, size, count, f) == count;  // Empty vectors may have null data()
+        };
+        uint32_t header[2] = {FILE_MAGIC, FILE_VERSION};
+        write(header, sizeof(uint32_t), 2);
+        write(&V, sizeof(V), 1);
+        write(&shortcuts, sizeof(shortcuts), 1);
+        write(rank.data(), sizeof(int), rank.size());
+        for (int side = 0; side < 2; side++) {
+            write(offsets[side].data(), sizeof(long long), offsets[side].size());
+            write(targets[side].data(), sizeof(int), targets[side].size());
+            write(weights[side].data(), sizeof(int), weights[side].size());
+        }
+        return fclose(f) == 0 && ok;
+    }
+
+    bool load(const string& path) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        fseek(f, 0, SEEK_END);
+        long long fileBytes = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        auto read = [&](void* data, size_t size, size_t count) {
+            return count == 0 || fread(data, size, count, f) == count;
+        };
+        uint32_t header[2] = {};
+        bool ok = read(header, sizeof(uint32_t), 2) && header[0] == FILE_MAGIC && header[1] == FILE_VERSION &&
+                  read(&V, sizeof(V), 1) && V >= 0 && V <= fileBytes / 4 &&
+                  read(&shortcuts, sizeof(shortcuts), 1);
+        if (ok) {
+            rank.resize(V);
+            ok = read(rank.data(), sizeof(int), V);
+        }
+        for (int side = 0; ok && side < 2; side++) {
+            offsets[side].resize(V + 1);
+            ok = read(offsets[side].data(), sizeof(long long), V + 1) &&
+                 offsets[side][0] == 0 && offsets[side][V] >= 0 && offsets[side][V] <= fileBytes / 8;
+            if (!ok) break;
+            targets[side].resize(offsets[side][V]);
+            weights[side].resize(offsets[side][V]);
+            ok = read(targets[side].data(), sizeof(int), targets[side].size()) &&
+                 read(weights[side].data(), sizeof(int), weights[side].size());
+            // Reject corrupt files here rather than crash in query()
+            for (int v = 0; ok && v < V; v++) ok = offsets[side][v] <= offsets[side][v + 1];
+            for (size_t e = 0; ok && e < targets[side].size(); e++) {
+                ok = targets[side][e] >= 0 && targets[side][e] < V && weights[side][e] >= 0;
+            }
+        }
+        fclose(f);
+        if (!ok) *this = ContractionHierarchy();
+        return ok;
+    }
+};
+
+// Iterative depth-first searches over a CSRGraph
+// Each stack frame is {vertex, next arc}, exactly what a recursive call keeps,
+// so visit and finish orders match the recursive versions while depth is
+// bounded only by memory. All buffers are sized once for V and reused by
+// every call; returned references stay valid until the next call.
+class DepthFirstSearch {
+private:
+    const CSRGraph& g;
+    vector<pair<int, long long>> frames;  // {vertex, next arc}
+    vector<int> state;   // 0 unvisited, 1 on the DFS stack, 2 finished; Tarjan: discovery index
+    vector<int> parent;
+    vector<int> low, comp, sccStack;
+    vector<int> result;
+    int sccCount = 0;
+
+    void reset() {
+        fill(state.begin(), state.end(), 0);
+        frames.clear();
+        result.clear();
+    }
+
+    void enter(int v) {
+        state[v] = 1;
+        frames.push_back({v, g.edgeBegin(v)});
+    }
+
+public:
+    DepthFirstSearch(const CSRGraph& graph) : g(graph) {
+        int V = g.numVertices();
+        frames.reserve(V);
+        state.resize(V);
+        parent.resize(V);
+        low.resize(V);
+        comp.resize(V);
+        sccStack.reserve(V);
+        result.reserve(V);
+    }
+
+    // Preorder from start, same as the recursive DFS
+    const vector<int>& order(int start) {
+        reset();
+        enter(start);
+        result.push_back(start);
+        while (!frames.empty()) {
+            int u = frames.back().first;
+            long long& e = frames.back().second;
+            if (e == g.edgeEnd(u)) {
+                frames.pop_back();
+                continue;
+            }
+            int v = g.target(e++);
+            if (!state[v]) {
+                enter(v);
+                result.push_back(v);
+            }
+        }
+        return result;
+    }
+
+    // Any visited neighbor other than the DFS parent closes a cycle
+    bool hasCycleUndirected() {
+        reset();
+        for (int s = 0; s < g.numVertices(); s++) {
+            if (state[s]) continue;
+            parent[s] = -1;
+            enter(s);
+            while (!frames.empty()) {
+                int u = frames.back().first;
+                long long& e = frames.back().second;
+                if (e == g.edgeEnd(u)) {
+                    frames.pop_back();
+                    continue;
+                }
+                int v = g.target(e++);
+                if (!state[v]) {
+                    parent[v] = u;
+                    enter(v);
+                } else if (v != parent[u]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Reverse postorder; empty if the graph has a cycle (an arc back to a
+    // vertex still on the DFS stack)
+    const vector<int>& topologicalSort() {
+        reset();
+        for (int s = 0; s < g.numVertices(); s++) {
+            if (state[s]) continue;
+            enter(s);
+            while (!frames.empty()) {
+                int u = frames.back().first;
+                long long& e = frames.back().second;
+                if (e == g.edgeEnd(u)) {
+                    state[u] = 2;
+                    result.push_back(u);
+                    frames.pop_back();
+                    continue;
+                }
+                int v = g.target(e++);
+                if (!state[v]) {
+                    enter(v);
+                } else if (state[v] == 1) {
+                    result.clear();
+                    return result;
+                }
+            }
+        }
+        reverse(result.begin(), result.end());
+        return result;
+    }
+
+    bool hasCycleDirected() { return g.numVertices() > 0 && topologicalSort().empty(); }
+
+    // Tarjan's SCC, iterative. state[v] is v's discovery index and low[v] the
+    // lowest index reachable through v's subtree plus one back arc. A vertex
+    // whose low equals its own index roots a component: everything above it
+    // on sccStack. Visited vertices without a component are exactly those on
+    // sccStack. Components are numbered in reverse topological order.
+    int stronglyConnectedComponents() {
+        reset();
+        fill(comp.begin(), comp.end(), -1);
+        sccStack.clear();
+        sccCount = 0;
+        int index = 0;
+        auto visit = [&](int v) {
+            state[v] = low[v] = ++index;
+            sccStack.push_back(v);
+            frames.push_back({v, g.edgeBegin(v)});
+        };
+        for (int s = 0; s < g.numVertices(); s++) {
+            if (state[s]) continue;
+            visit(s);
+            while (!frames.empty()) {
+                int u = frames.back().first;
+                long long& e = frames.back().second;
+                if (e < g.edgeEnd(u)) {
+                    int v = g.target(e++);
+                    if (!state[v]) visit(v);
+                    else if (comp[v] == -1) low[u] = min(low[u], state[v]);
+                    continue;
+                }
+                frames.pop_back();
+                if (!frames.empty()) {
+                    int p = frames.back().first;
+                    low[p] = min(low[p], low[u]);
+                }
+                if (low[u] == state[u]) {
+                    int v;
+                    do {
+                        v = sccStack.back();
+                        sccStack.pop_back();
+                        comp[v] = sccCount;
+                    } while (v != u);
+                    sccCount++;
+                }
+            }
+        }
+        return sccCount;
+    }
+
+    // Component of each vertex from the last stronglyConnectedComponents()
+    const vector<int>& components() const { return comp; }
+};
+
+// Parallel connected components (Afforest, Sutton et al.)
+// A Shiloach-Vishkin style forest: label[v] points toward a root, and
+// linking two trees hooks the higher root under the lower with one CAS, so
+// every root is the smallest vertex of its component and needs no locks.
+//   1. Link each vertex along its first NEIGHBOR_ROUNDS arcs, compressing
+//      after each round; this already joins most of the giant component.
+//   2. Sample labels to find the most frequent (giant) component.
+//   3. Link the remaining arcs of vertices outside it; the giant component's
+//      own arcs are skipped, which is most of the graph.
+// Directed graphs get weakly connected components; there the skip in step 3
+// would miss arcs into the giant component, so every vertex is processed.
+struct ComponentResult {
+    vector<int> label;  // Smallest vertex of the component
+    int count = 0;
+};
+
+ComponentResult parallelComponents(const CSRGraph& g, int threads = defaultThreads()) {
+    const int NEIGHBOR_ROUNDS = 2;
+    const int SAMPLES = 1024;
+    int V = g.numVertices();
+    vector<atomic<int>> label(V);
+    for (int v = 0; v < V; v++) label[v].store(v, memory_order_relaxed);
+
+    auto link = [&](int u, int v) {
+        int p1 = label[u].load(memory_order_relaxed);
+        int p2 = label[v].load(memory_order_relaxed);
+        while (p1 != p2) {
+            int high = max(p1, p2), low = min(p1, p2);
+            int parentOfHigh = label[high].load(memory_order_relaxed);
+            if (parentOfHigh == low) break;  // Already hooked
+            if (parentOfHigh == high) {
+                int expected = high;
+                if (label[high].compare_exchange_strong(expected, low, memory_order_relaxed)) break;
+            }
+            // high was hooked meanwhile: retry from both current parents
+            p1 = label[label[high].load(memory_order_relaxed)].load(memory_order_relaxed);
+            p2 = label[low].load(memory_order_relaxed);
+        }
+    };
+    auto compress = [&] {
+        parallelFor(V, threads, 4096, [&](long long begin, long long end, int) {
+            for (long long v = begin; v < end; v++) {
+                int p = label[v].load(memory_order_relaxed);
+                while (p != label[p].load(memory_order_relaxed)) p = label[p].load(memory_order_relaxed);
+                label[v].store(p, memory_order_relaxed);
+            }
+        });
+    };
+
+    for (int r = 0; r < NEIGHBOR_ROUNDS; r++) {
+        parallelFor(V, threads, 4096, [&](long long begin, long long end, int) {
+            for (long long u = begin; u < end; u++) {
+                if (g.edgeBegin(u) + r < g.edgeEnd(u)) link(u, g.target(g.edgeBegin(u) + r));
+            }
+        });
+        compress();
+    }
+
+    int giant = -1;
+    if (!g.isDirected() && V > 0) {
+        vector<int> sample(SAMPLES);
+        uint64_t x = 0x9E3779B97F4A7C15ULL;
+        for (int& c : sample) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            c = label[x % V].load(memory_order_relaxed);
+        }
+        sort(sample.begin(), sample.end());
+        int bestRun = 0;
+        for (int i = 0, j; i < SAMPLES; i = j) {
+            for (j = i; j < SAMPLES && sample[j] == sample[i]; j++) {}
+            if (j - i > bestRun) {
+                bestRun = j - i;
+                giant = sample[i];
+            }
+        }
+    }
+
+    parallelFor(V, threads, 4096, [&](long long begin, long long end, int) {
+        for (long long u = begin; u < end; u++) {
+            if (label[u].load(memory_order_relaxed) == giant) continue;
+            for (long long e = g.edgeBegin(u) + NEIGHBOR_ROUNDS; e < g.edgeEnd(u); e++) link(u, g.target(e));
+        }
+    });
+    compress();
+
+    ComponentResult result;
+    result.label.resize(V);
+    for (int v = 0; v < V; v++) {
+        result.label[v] = label[v].load(memory_order_relaxed);
+        if (result.label[v] == v) result.count++;
+    }
+    return result;
+}
+
+// Dynamic graph for streaming edge updates
+// Each vertex keeps up to INLINE {neighbor, weight} pairs in place (one cache
+// line with the header) and switches to an open-addressing hash table keyed by
+// neighbor once it outgrows them, so hasEdge / removeEdge are O(1) expected
+// instead of a list scan. Edges are a set: adding an existing edge updates its
+// weight. Low-degree vertices never allocate.
+class DynamicGraph {
+private:
+    static const int INLINE = 6;
+    static constexpr int EMPTY = -1;
+
+    struct Adjacency {
+        int count = 0;
+        int capacity = 0;                  // 0 while inline, else table slots (power of 2)
+        pair<int, int>* table = nullptr;   // {neighbor, weight}, neighbor EMPTY if free
+        pair<int, int> small[INLINE];
+    };
+
+    int V;
+    bool directed;
+    vector<Adjacency> adj;
+    atomic<long long> arcs{0};
+
+    static size_t slotFor(int v, int capacity) {
+        uint32_t h = (uint32_t)v * 0x9E3779B1u;
+        return (h ^ (h >> 15)) & (capacity - 1);
+    }
+
+    static const pair<int, int>* findArc(const Adjacency& a, int v) {
+        if (!a.table) {
+            for (int i = 0; i < a.count; i++) {
+                if (a.small[i].first == v) return &a.small[i];
+            }
+            return nullptr;
+        }
+        for (size_t i = slotFor(v, a.capacity);; i = (i + 1) & (a.capacity - 1)) {
+            if (a.table[i].first == v) return &a.table[i];
+            if (a.table[i].first == EMPTY) return nullptr;
+        }
+    }
+
+    static pair<int, int>* findArc(Adjacency& a, int v) {
+        return const_cast<pair<int, int>*>(findArc(static_cast<const Adjacency&>(a), v));
+    }
+
+    static void tableInsert(pair<int, int>* table, int capacity, int v, int w) {
+        size_t i = slotFor(v, capacity);
+        while (table[i].first != EMPTY) i = (i + 1) & (capacity - 1);
+        table[i] = {v, w};
+    }
+
+    static void rebuild(Adjacency& a, int capacity) {
+        pair<int, int>* table = new pair<int, int>[capacity];
+        fill(table, table + capacity, make_pair(EMPTY, 0));
+        forEachArc(a, [&](int v, int w) { tableInsert(table, capacity, v, w); });
+        delete[] a.table;
+        a.table = table;
+        a.capacity = capacity;
+    }
+
+    // Returns true if the arc is new
+    static bool insertArc(Adjacency& a, int v, int w) {
+        if (pair<int, int>* arc = findArc(a, v)) {
+            arc->second = w;
+            return false;
+        }
+        if (!a.table && a.count < INLINE) {
+            a.small[a.count++] = {v, w};
+            return true;
+        }
+        if (!a.table || (a.count + 1) * 4 > a.capacity * 3) rebuild(a, a.table ? a.capacity * 2 : 16);
+        tableInsert(a.table, a.capacity, v, w);
+        a.count++;
+        return true;
+    }
+
+    // Returns true if the arc existed
+    static bool eraseArc(Adjacency& a, int v) {
+        pair<int, int>* arc = findArc(a, v);
+        if (!arc) return false;
+        if (!a.table) {
+            *arc = a.small[--a.count];
+            return true;
+        }
+        // Backward-shift deletion: pull later entries of the probe run into
+        // the hole so lookups never need tombstones
+        size_t mask = a.capacity - 1;
+        size_t hole = arc - a.table;
+        for (size_t i = (hole + 1) & mask; a.table[i].first != EMPTY; i = (i + 1) & mask) {
+            size_t home = slotFor(a.table[i].first, a.capacity);
+            if (((i - home) & mask) >= ((i - hole) & mask)) {
+                a.table[hole] = a.table[i];
+                hole = i;
+            }
+        }
+        a.table[hole].first = EMPTY;
+        if (--a.count <= INLINE / 2) {  // Shrunk back: return to inline storage
+            pair<int, int>* table = a.table;
+            int capacity = a.capacity;
+            a.table = nullptr;
+            a.capacity = 0;
+            a.count = 0;
+            for (int i = 0; i < capacity; i++) {
+                if (table[i].first != EMPTY) a.small[a.count++] = table[i];
+            }
+            delete[] table;
+        }
+        return true;
+    }
+
+    template<typename F>
+    static void forEachArc(const Adjacency& a, F f) {
+        if (!a.table) {
+            for (int i = 0; i < a.count; i++) f(a.small[i].first, a.small[i].second);
+        } else {
+            for (int i = 0; i < a.capacity; i++) {
+                if (a.table[i].first != EMPTY) f(a.table[i].first, a.table[i].second);
+            }
+        }
+    }
+
+public:
+    DynamicGraph(int vertices, bool isDirected = false) : V(vertices), directed(isDirected), adj(vertices) {}
+
+    ~DynamicGraph() {
+        for (auto& a : adj) delete[] a.table;
+    }
+
+    DynamicGraph(const DynamicGraph&) = delete;
+    DynamicGraph& operator=(const DynamicGraph&) = delete;
+
+    int numVertices() const { return V; }
+    long long numArcs() const { return arcs.load(); }  // Undirected edges count twice
+    bool isDirected() const { return directed; }
+    int degree(int u) const { return adj[u].count; }
+
+    // Add or reweight an edge - O(1) expected
+    void addEdge(int u, int v, int weight = 1) {
+        arcs += insertArc(adj[u], v, weight);
+        if (!directed && u != v) arcs += insertArc(adj[v], u, weight);
+    }
+
+    // Remove edge - O(1) expected
+    void removeEdge(int u, int v) {
+        arcs -= eraseArc(adj[u], v);
+        if (!directed && u != v) arcs -= eraseArc(adj[v], u);
+    }
+
+    // Check if edge exists - O(1) expected
+    bool hasEdge(int u, int v) const { return findArc(adj[u], v) != nullptr; }
+
+    // Calls f(neighbor, weight) for every arc out of u, in no particular order
+    template<typename F>
+    void forEachNeighbor(int u, F f) const { forEachArc(adj[u], f); }
+
+    // Apply a batch: all deletes, then all inserts. Updates are split into
+    // per-endpoint arc updates and grouped by source vertex, so each
+    // adjacency is modified by exactly one thread and no locks are needed.
+    void applyUpdates(const vector<Edge>& inserts, const vector<pair<int, int>>& deletes,
+                      int threads = defaultThreads()) {
+        struct ArcUpdate {
+            int u, v, weight;
+            bool remove;  // Any weight, negative included, is a valid insert
+        };
+        vector<ArcUpdate> updates;
+        updates.reserve((deletes.size() + inserts.size()) * (directed ? 1 : 2));
+        for (auto& d : deletes) {
+            updates.push_back({d.first, d.second, 0, true});
+            if (!directed && d.first != d.second) updates.push_back({d.second, d.first, 0, true});
+        }
+        for (auto& e : inserts) {
+            updates.push_back({e.u, e.v, e.weight, false});
+            if (!directed && e.u != e.v) updates.push_back({e.v, e.u, e.weight, false});
+        }
+        stable_sort(updates.begin(), updates.end(), [](const ArcUpdate& a, const ArcUpdate& b) { return a.u < b.u; });
+
+        vector<size_t> groups;  // Start of each source vertex's run
+        for (size_t i = 0; i < updates.size(); i++) {
+            if (i == 0 || updates[i].u != updates[i - 1].u) groups.push_back(i);
+        }
+        groups.push_back(updates.size());
+
+        parallelFor(groups.size() - 1, threads, 64, [&](long long begin, long long end, int) {
+            long long delta = 0;
+            for (long long g = begin; g < end; g++) {
+                for (size_t i = groups[g]; i < groups[g + 1]; i++) {
+                    const ArcUpdate& up = updates[i];
+                    if (up.remove) delta -= eraseArc(adj[up.u], up.v);
+                    else delta += insertArc(adj[up.u], up.v, up.weight);
+                }
+            }
+            arcs += delta;
+        });
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = adj.size() * sizeof(Adjacency);
+        for (auto& a : adj) bytes += a.capacity * sizeof(pair<int, int>);
+        return bytes;
+    }
+
+    // BFS - O(V + E), returns the visit order
+    vector<int> BFS(int start) const {
+        vector<bool> visited(V, false);
+        vector<int> order = {start};
+        visited[start] = true;
+        for (size_t head = 0; head < order.size(); head++) {
+            forEachNeighbor(order[head], [&](int v, int) {
+                if (!visited[v]) {
+                    visited[v] = true;
+                    order.push_back(v);
+                }
+            });
+        }
+        return order;
+    }
+
+    // Shortest path in unweighted graph - O(V + E)
+    vector<int> shortestPath(int src) const {
+        vector<int> dist(V, INT_MAX);
+        vector<int> queue = {src};
+        dist[src] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int u = queue[head];
+            forEachNeighbor(u, [&](int v, int) {
+                if (dist[v] == INT_MAX) {
+                    dist[v] = dist[u] + 1;
+                    queue.push_back(v);
+                }
+            });
+        }
+        return dist;
+    }
+
+    // Dijkstra's Algorithm - O((V+E) log V)
+    vector<int> dijkstra(int src) const {
+        vector<int> dist(V, INT_MAX);
+        priority_queue<pair<int,int>, vector<pair<int,int>>, greater<pair<int,int>>> pq;
+        dist[src] = 0;
+        pq.push({0, src});
+        while (!pq.empty()) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > dist[u]) continue;
+            forEachNeighbor(u, [&](int v, int w) {
+                if (d + w < dist[v]) {
+                    dist[v] = d + w;
+                    pq.push({dist[v], v});
+                }
+            });
+        }
+        return dist;
+    }
+
+    // Immutable copy for the CSR algorithms (parallel BFS, components, ...)
+    CSRGraph snapshot() const {
+        vector<Edge> edges;
+        edges.reserve(numArcs());
+        for (int u = 0; u < V; u++) {
+            forEachNeighbor(u, [&](int v, int w) { edges.push_back({u, v, w}); });
+        }
+        return CSRGraph(V, edges, true);  // Both directions are already stored
+    }
+};
+
+// Benchmark: adjacency lists vs CSR on the same graph
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkCSR(int V, long long m) {
+    vector<Edge> edges = randomEdges(V, m, 100, 42);
+    for (auto& e : edges) {  // Even-odd edges only, so isBipartite scans everything
+        e.u &= ~1;
+        e.v |= 1;
+    }
+    Graph g(V);
+    double buildList = timeMs([&] { for (auto& e : edges) g.addEdge(e.u, e.v, e.weight); });
+    CSRGraph* csr = nullptr;
+    double buildCSR = timeMs([&] { csr = new CSRGraph(V, edges); });
+
+    long long check = 0;
+    printf("  %d vertices, %lld edges, CSR %.0f MB\n", V, m, csr->memoryBytes() / 1e6);
+    printf("  %-14s %10s %10s\n", "", "list (ms)", "CSR (ms)");
+    printf("  %-14s %10.1f %10.1f\n", "build", buildList, buildCSR);
+    printf("  %-14s %10.1f %10.1f\n", "shortestPath",
+           timeMs([&] { check += g.shortestPath(0)[V - 1]; }),
+           timeMs([&] { check -= csr->shortestPath(0)[V - 1]; }));
+    printf("  %-14s %10.1f %10.1f\n", "dijkstra",
+           timeMs([&] { check += g.dijkstra(0)[V - 1]; }),
+           timeMs([&] { check -= csr->dijkstra(0)[V - 1]; }));
+    printf("  %-14s %10.1f %10.1f\n", "isBipartite",
+           timeMs([&] { check += g.isBipartite(); }),
+           timeMs([&] { check -= csr->isBipartite(); }));
+    if (check != 0) cout << "  list/CSR results differ!\n";
+    delete csr;
+}
+
+// Benchmark: serial queue BFS vs direction-optimizing BFS on an R-MAT graph
+void benchmarkParallelBFS(int scale, int edgeFactor) {
+    CSRGraph g(1 << scale, rmatEdges(scale, edgeFactor, 100, 7));
+    int V = g.numVertices();
+    int src = 0;
+    while (g.degree(src) == 0) src++;
+
+    vector<int> expected;
+    double serial = timeMs([&] { expected = g.shortestPath(src); });
+    long long reached = V - count(expected.begin(), expected.end(), INT_MAX);
+    printf("  R-MAT scale %d: %d vertices, %lld arcs, %lld reachable\n", scale, V, g.numArcs(), reached);
+    printf("  %-22s %10s %10s\n", "", "time (ms)", "MTEPS");
+    printf("  %-22s %10.1f %10.1f\n", "serial shortestPath", serial, g.numArcs() / serial / 1e3);
+
+    for (int threads = 1;; threads *= 2) {
+        threads = min(threads, defaultThreads());
+        BFSResult r;
+        double t = timeMs([&] { r = parallelBFS(g, src, threads); });
+        char label[32];
+        snprintf(label, sizeof(label), "parallelBFS x%d", threads);
+        printf("  %-22s %10.1f %10.1f   (%d top-down, %d bottom-up)%s\n", label, t, g.numArcs() / t / 1e3,
+               r.topDownSteps, r.bottomUpSteps, r.dist == expected ? "" : "  MISMATCH");
+        if (threads == defaultThreads()) break;
+    }
+}
+
+// Benchmark: cost of one parallelFor call, paid per BFS level, delta-stepping
+// round and components phase - pool wake-up vs creating and joining threads
+void benchmarkParallelForOverhead(int threads, int calls) {
+    atomic<long long> sink(0);
+    double pool = timeMs([&] {
+        for (int i = 0; i < calls; i++) {
+            parallelFor(threads, threads, 1, [&](long long begin, long long end, int) { sink += end - begin; });
+        }
+    });
+    double spawn = timeMs([&] {
+        for (int i = 0; i < calls; i++) {
+            vector<thread> pool;
+            for (int t = 1; t < threads; t++) pool.emplace_back([&] { sink++; });
+            sink++;
+            for (auto& t : pool) t.join();
+        }
+    });
+    printf("  parallelFor overhead, %d threads: %.1f us/call (create + join per call: %.1f us)\n",
+           threads, pool * 1e3 / calls, spawn * 1e3 / calls);
+}
+
+// Benchmark: Graph::dijkstra vs CSR dijkstra vs delta-stepping
+void benchmarkDeltaSteppingOn(const char* name, int V, const vector<Edge>& edges) {
+    Graph list(V);
+    for (auto& e : edges) list.addEdge(e.u, e.v, e.weight);
+    CSRGraph g(V, edges);
+
+    vector<int> expected;
+    printf("  %s: %d vertices, %lld arcs, max weight %d\n", name, V, g.numArcs(), g.maxWeight());
+    printf("  %-28s %10.1f\n", "Graph::dijkstra", timeMs([&] { expected = list.dijkstra(0); }));
+    printf("  %-28s %10.1f\n", "CSRGraph::dijkstra", timeMs([&] { g.dijkstra(0); }));
+
+    int autoDelta = max<long long>(1, g.maxWeight() * (long long)V / g.numArcs());
+    vector<pair<int, int>> runs;  // {threads, delta}
+    for (int threads = 1;; threads = min(threads * 2, defaultThreads())) {
+        runs.push_back({threads, autoDelta});
+        if (threads == defaultThreads()) break;
+    }
+    for (int delta : {1, autoDelta * 4, g.maxWeight() * 4}) runs.push_back({defaultThreads(), delta});
+
+    for (auto [threads, delta] : runs) {
+        vector<int> dist;
+        double t = timeMs([&] { dist = deltaStepping(g, 0, delta, threads); });
+        char label[48];
+        snprintf(label, sizeof(label), "deltaStepping x%d, delta=%d", threads, delta);
+        printf("  %-28s %10.1f%s\n", label, t, dist == expected ? "" : "  MISMATCH");
+    }
+}
+
+void benchmarkDeltaStepping() {
+    benchmarkDeltaSteppingOn("grid 1000x1000", 1000 * 1000, gridEdges(1000, 1000, 100, 3));
+    benchmarkDeltaSteppingOn("R-MAT scale 18", 1 << 18, rmatEdges(18, 8, 100, 5));
+}
+
+// Benchmark: integer-weight queues, time and memory
+void benchmarkIntegerDijkstraOn(const char* name, int V, const vector<Edge>& edges) {
+    CSRGraph g(V, edges);
+    vector<int> expected;
+    printf("  %s: %d vertices, %lld arcs, max weight %d -> auto picks %s\n", name, V, g.numArcs(),
+           g.maxWeight(), chooseQueue(g) == DijkstraQueue::Dial ? "Dial" : "radix heap");
+    printf("  %-22s %10s %12s\n", "", "time (ms)", "queue (KB)");
+    printf("  %-22s %10.1f %12s\n", "CSRGraph::dijkstra", timeMs([&] { expected = g.dijkstra(0); }), "-");
+
+    struct { const char* name; DijkstraQueue queue; } variants[] = {
+        {"binary heap", DijkstraQueue::BinaryHeap},
+        {"Dial buckets", DijkstraQueue::Dial},
+        {"radix heap", DijkstraQueue::Radix},
+    };
+    for (auto& variant : variants) {
+        if (variant.queue == DijkstraQueue::Dial && g.maxWeight() > DIAL_MAX_WEIGHT) {
+            printf("  %-22s %10s %12s   (skipped: scans every distance up to the max)\n", variant.name, "-", "-");
+            continue;
+        }
+        vector<int> dist;
+        size_t bytes = 0;
+        double t = timeMs([&] { dist = integerDijkstra(g, 0, variant.queue, &bytes); });
+        printf("  %-22s %10.1f %12zu%s\n", variant.name, t, bytes / 1024, dist == expected ? "" : "  MISMATCH");
+    }
+}
+
+void benchmarkIntegerDijkstra() {
+    benchmarkIntegerDijkstraOn("grid 1000x1000", 1000 * 1000, gridEdges(1000, 1000, 100, 3));
+    benchmarkIntegerDijkstraOn("grid 1000x1000", 1000 * 1000, gridEdges(1000, 1000, 1000000, 3));
+    benchmarkIntegerDijkstraOn("R-MAT scale 18", 1 << 18, rmatEdges(18, 8, 100, 5));
+}
+
+// Benchmark: point-to-point queries on a road-like grid
+void benchmarkPointToPoint(int rows, int cols, int queries) {
+    int V = rows * cols;
+    CSRGraph g(V, gridEdges(rows, cols, 100, 11));
+    PointToPointEngine engine(g);
+    LandmarkHeuristic* alt = nullptr;
+    double altBuild = timeMs([&] { alt = new LandmarkHeuristic(g, 8); });
+    auto manhattan = [cols](int v, int t) {  // Admissible: every edge weighs >= 1
+        return abs(v / cols - t / cols) + abs(v % cols - t % cols);
+    };
+
+    vector<pair<int, int>> pairs(queries);
+    uint64_t x = 99;
+    for (auto& p : pairs) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        p = {(int)(x % V), (int)((x >> 32) % V)};
+    }
+    vector<int> expected(queries);
+    for (int i = 0; i < queries; i++) expected[i] = engine.dijkstra(pairs[i].first, pairs[i].second).dist;
+
+    printf("  grid %dx%d, %d random queries, ALT: 8 landmarks, %.0f ms, %.0f MB\n", rows, cols, queries,
+           altBuild, alt->memoryBytes() / 1e6);
+    printf("  %-26s %12s %14s\n", "", "ms / query", "settled / query");
+    double full = timeMs([&] { for (int i = 0; i < 5; i++) g.dijkstra(pairs[i].first); }) / 5;
+    printf("  %-26s %12.2f %14d\n", "CSRGraph::dijkstra (all)", full, V);
+
+    auto run = [&](const char* name, auto query) {
+        long long settled = 0;
+        bool ok = true;
+        double t = timeMs([&] {
+            for (int i = 0; i < queries; i++) {
+                PathQuery q = query(pairs[i].first, pairs[i].second);
+                settled += q.settled;
+                ok &= q.dist == expected[i];
+            }
+        });
+        printf("  %-26s %12.3f %14lld%s\n", name, t / queries, settled / queries, ok ? "" : "  MISMATCH");
+    };
+    run("early-stop Dijkstra", [&](int s, int t) { return engine.dijkstra(s, t); });
+    run("bidirectional Dijkstra", [&](int s, int t) { return engine.bidirectional(s, t); });
+    run("A* (Manhattan)", [&](int s, int t) { return engine.astar(s, t, manhattan); });
+    run("A* (ALT landmarks)", [&](int s, int t) { return engine.astar(s, t, *alt); });
+
+    int threads = defaultThreads();
+    double t = timeMs([&] {
+        parallelFor(queries, threads, 1, [&](long long begin, long long end, int) {
+            for (long long i = begin; i < end; i++) engine.bidirectional(pairs[i].first, pairs[i].second);
+        });
+    });
+    printf("  bidirectional on %d thread(s): %.0f queries/s\n", threads, queries / t * 1e3);
+    delete alt;
+}
+
+// Benchmark: CH preprocessing, index size and query latency
+void benchmarkContractionHierarchyOn(const char* name, const CSRGraph& g, int queries) {
+    int V = g.numVertices();
+    PointToPointEngine engine(g);
+    ContractionHierarchy* ch = nullptr;
+    double build = timeMs([&] { ch = new ContractionHierarchy(g); });
+    printf("  %s: preprocessing %.0f ms, %lld shortcuts (%.2f per arc), index %.1f MB (graph %.1f MB)\n",
+           name, build, ch->numShortcuts(), (double)ch->numShortcuts() / g.numArcs(),
+           ch->memoryBytes() / 1e6, g.memoryBytes() / 1e6);
+
+    const string path = "bench.ch";
+    ContractionHierarchy loaded;
+    double saveMs = timeMs([&] { ch->save(path); });
+    double loadMs = timeMs([&] { loaded.load(path); });
+    printf("  save %.1f ms, load %.1f ms\n", saveMs, loadMs);
+    remove(path.c_str());
+
+    vector<pair<int, int>> pairs(queries);
+    uint64_t x = 7;
+    for (auto& p : pairs) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        p = {(int)(x % V), (int)((x >> 32) % V)};
+    }
+    vector<int> expected(queries);
+    double bidi = timeMs([&] {
+        for (int i = 0; i < queries; i++) expected[i] = engine.bidirectional(pairs[i].first, pairs[i].second).dist;
+    });
+
+    long long settled = 0;
+    bool ok = true;
+    double t = timeMs([&] {
+        for (int i = 0; i < queries; i++) {
+            PathQuery q = loaded.query(pairs[i].first, pairs[i].second);
+            settled += q.settled;
+            ok &= q.dist == expected[i];
+        }
+    });
+    printf("  %-24s %12s %14s\n", "", "us / query", "settled / query");
+    printf("  %-24s %12.1f %14s\n", "bidirectional Dijkstra", bidi / queries * 1e3, "");
+    printf("  %-24s %12.1f %14lld%s\n", "CH query (loaded file)", t / queries * 1e3, settled / queries,
+           ok ? "" : "  MISMATCH");
+    delete ch;
+}
+
+void benchmarkContractionHierarchy(int queries) {
+    benchmarkContractionHierarchyOn("grid 200x200", CSRGraph(200 * 200, gridEdges(200, 200, 100, 11)), queries);
+    benchmarkContractionHierarchyOn("grid 400x400", CSRGraph(400 * 400, gridEdges(400, 400, 100, 11)), queries);
+    benchmarkContractionHierarchyOn("R-MAT scale 14", CSRGraph(1 << 14, rmatEdges(14, 8, 100, 11)), queries);
+}
+
+// Benchmark: iterative DFS family on a long chain and an R-MAT graph
+void benchmarkDFS(int chainLength) {
+    // Recursion would need one stack frame per vertex here
+    Graph path(chainLength);
+    for (int i = 0; i + 1 < chainLength; i++) path.addEdge(i, i + 1);
+    bool cyclic = false;
+    double listMs = timeMs([&] { cyclic = path.hasCycleUndirected(); });
+    printf("  Graph::hasCycleUndirected on a %d-vertex path: %s, %.0f ms\n", chainLength, cyclic ? "cycle" : "acyclic", listMs);
+
+    vector<Edge> chain;
+    for (int i = 0; i + 1 < chainLength; i++) chain.push_back({i, i + 1, 1});
+    chain.push_back({chainLength - 1, 0, 1});  // Close the ring: one big SCC
+    CSRGraph ring(chainLength, chain, true);
+    CSRGraph dag(chainLength, vector<Edge>(chain.begin(), chain.end() - 1), true);
+    CSRGraph rmat(1 << 18, rmatEdges(18, 8, 1, 5), true);
+
+    struct { const char* name; const CSRGraph& g; } graphs[] = {
+        {"chain (DAG)", dag}, {"ring", ring}, {"R-MAT scale 18", rmat},
+    };
+    printf("  %-16s %10s %10s %10s %14s\n", "", "order", "topo", "SCC", "SCCs");
+    for (auto& entry : graphs) {
+        DepthFirstSearch dfs(entry.g);
+        int sccs = 0;
+        double orderMs = timeMs([&] { dfs.order(0); });
+        double topoMs = timeMs([&] { dfs.topologicalSort(); });
+        double sccMs = timeMs([&] { sccs = dfs.stronglyConnectedComponents(); });
+        printf("  %-16s %10.1f %10.1f %10.1f %14d\n", entry.name, orderMs, topoMs, sccMs, sccs);
+    }
+}
+
+// Benchmark: serial BFS components vs Afforest
+void benchmarkComponentsOn(const char* name, const CSRGraph& g) {
+    int expected = 0;
+    double serial = timeMs([&] { expected = g.countComponents(); });
+    printf("  %s: %d vertices, %lld arcs\n", name, g.numVertices(), g.numArcs());
+    printf("  %-26s %10.1f %12d\n", "CSRGraph::countComponents", serial, expected);
+    for (int threads = 1;; threads = min(threads * 2, defaultThreads())) {
+        ComponentResult r;
+        double t = timeMs([&] { r = parallelComponents(g, threads); });
+        char label[40];
+        snprintf(label, sizeof(label), "parallelComponents x%d", threads);
+        printf("  %-26s %10.1f %12d%s\n", label, t, r.count, r.count == expected ? "" : "  MISMATCH");
+        if (threads == defaultThreads()) break;
+    }
+}
+
+void benchmarkComponents() {
+    printf("  %-26s %10s %12s\n", "", "time (ms)", "components");
+    benchmarkComponentsOn("R-MAT scale 20", CSRGraph(1 << 20, rmatEdges(20, 16, 1, 9)));
+    benchmarkComponentsOn("grid 1000x1000", CSRGraph(1000 * 1000, gridEdges(1000, 1000, 1, 9)));
+}
+
+// Benchmark: list Graph vs DynamicGraph under streaming updates on a skewed graph.
+// List scans over hub vertices take seconds, so the list only runs the first
+// LIST_OPS operations of each kind; times are per operation.
+void benchmarkDynamicGraph(int scale, int edgeFactor, int batch) {
+    const int LIST_OPS = 2000;
+    int V = 1 << scale;
+    vector<Edge> edges = rmatEdges(scale, edgeFactor, 100, 13);
+    Graph list(V);
+    DynamicGraph dyn(V);
+    double listBuild = timeMs([&] { for (auto& e : edges) list.addEdge(e.u, e.v, e.weight); });
+    double dynBuild = timeMs([&] { for (auto& e : edges) dyn.addEdge(e.u, e.v, e.weight); });
+
+    // Deletes and probes start at existing edges' sources, so hubs are hit often, as in real streams
+    vector<pair<int, int>> deletes(batch), probes(batch);
+    vector<Edge> inserts = rmatEdges(scale, 1, 100, 17);
+    inserts.resize(batch);
+    for (int i = 0; i < batch; i++) {
+        const Edge& e = edges[i * 7919LL % edges.size()];
+        deletes[i] = {e.u, e.v};
+        probes[i] = {edges[i * 104729LL % edges.size()].u, (int)(i * 2654435761u % V)};
+    }
+
+    auto perOp = [](double ms, int ops) { return ms * 1e3 / ops; };
+    int listOps = min(batch, LIST_OPS);
+    long long hits = 0;
+    printf("  R-MAT scale %d, %zu edges, batches of %d (list: first %d ops)\n", scale, edges.size(), batch, listOps);
+    printf("  %-24s %14s %14s\n", "", "list", "dynamic");
+    printf("  %-24s %11.0f ms %11.0f ms\n", "build", listBuild, dynBuild);
+    printf("  %-24s %11.2f us %11.2f us\n", "hasEdge",
+           perOp(timeMs([&] { for (int i = 0; i < listOps; i++) hits += list.hasEdge(probes[i].first, probes[i].second); }), listOps),
+           perOp(timeMs([&] { for (int i = 0; i < listOps; i++) hits -= dyn.hasEdge(probes[i].first, probes[i].second); }), listOps));
+    printf("  %-24s %11.2f us %11.2f us\n", "removeEdge",
+           perOp(timeMs([&] { for (int i = 0; i < listOps; i++) list.removeEdge(deletes[i].first, deletes[i].second); }), listOps),
+           perOp(timeMs([&] { for (int i = 0; i < listOps; i++) dyn.removeEdge(deletes[i].first, deletes[i].second); }), listOps));
+    printf("  %-24s %11.2f us %11.2f us\n", "addEdge",
+           perOp(timeMs([&] { for (int i = 0; i < listOps; i++) list.addEdge(inserts[i].u, inserts[i].v, inserts[i].weight); }), listOps),
+           perOp(timeMs([&] { for (int i = 0; i < listOps; i++) dyn.addEdge(inserts[i].u, inserts[i].v, inserts[i].weight); }), listOps));
+    bool same = hits == 0 && list.shortestPath(0) == dyn.shortestPath(0);
+
+    for (int threads = 1;; threads = min(threads * 2, defaultThreads())) {
+        char label[40];
+        snprintf(label, sizeof(label), "applyUpdates x%d", threads);
+        double ms = timeMs([&] { dyn.applyUpdates(inserts, deletes, threads); });
+        printf("  %-24s %14s %11.2f us  (%.0f ms per batch)\n", label, "", perOp(ms, 2 * batch), ms);
+        if (threads == defaultThreads()) break;
+    }
+    printf("  memory: dynamic %.0f MB vs list ~%.0f MB (32 B per list node); results %s\n",
+           dyn.memoryBytes() / 1e6, 2.0 * edges.size() * 32 / 1e6, same ? "match" : "DIFFER");
+}
+
+// Benchmark: loading an edge-list text file vs converting it once and mapping
+// the binary CSR file. The first BFS after mapping includes the page faults.
+void benchmarkCSRFile(int scale, int edgeFactor) {
+    const string text = "rmat.txt", bin = "rmat.csr";
+    writeEdgeList(text, rmatEdges(scale, edgeFactor, 100, 21));
+
+    vector<Edge> edges;
+    int V = 0;
+    Graph* list = nullptr;
+    double listMs = timeMs([&] {
+        readEdgeList(text, edges, V);
+        list = new Graph(V);
+        for (auto& e : edges) list->addEdge(e.u, e.v, e.weight);
+    });
+    CSRGraph memory;
+    double memoryMs = timeMs([&] {
+        vector<Edge> parsed;
+        readEdgeList(text, parsed, V);
+        memory = CSRGraph(V, parsed);
+    });
+    double convertMs = timeMs([&] { convertEdgeList(text, bin, false); });
+    CSRGraph mapped;
+    double mapMs = timeMs([&] { mapped.mapFile(bin); });
+    double bfsMapped = timeMs([&] { mapped.BFS(0); });
+    double bfsMemory = timeMs([&] { memory.BFS(0); });
+    CSRGraph verified;
+    double verifyMs = timeMs([&] { verified.mapFile(bin, true); });
+    bool same = mapped.numArcs() == memory.numArcs() && mapped.BFS(0) == memory.BFS(0) &&
+                mapped.dijkstra(0) == memory.dijkstra(0);
+
+    printf("  R-MAT scale %d, %zu edges\n", scale, edges.size());
+    printf("  %-32s %10.0f ms\n", "text -> Graph (addEdge)", listMs);
+    printf("  %-32s %10.0f ms\n", "text -> CSRGraph", memoryMs);
+    printf("  %-32s %10.0f ms  (once)\n", "convertEdgeList -> .csr", convertMs);
+    printf("  %-32s %10.2f ms\n", "mapFile", mapMs);
+    printf("  %-32s %10.0f ms\n", "mapFile, verify checksums", verifyMs);
+    printf("  %-32s %10.0f ms  (in memory %.0f ms)\n", "first BFS on mapped graph", bfsMapped, bfsMemory);
+    printf("  results %s\n", same ? "match" : "DIFFER");
+    delete list;
+    remove(text.c_str());
+    remove(bin.c_str());
+}
+
+// Command line: binary CSR files
+//   11_graph convert <edges.txt> <graph.csr> [--directed]
+//   11_graph info <graph.csr> [--verify]
+int runGraphTool(int argc, char** argv) {
+    string command = argv[1];
+    map<string, string> options;
+    vector<string> args;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--", 0) == 0) options[arg] = "1";
+        else args.push_back(arg);
+    }
+
+    if (command == "convert" && args.size() == 2) {
+        bool converted = false;
+        double ms = timeMs([&] { converted = convertEdgeList(args[0], args[1], options.count("--directed")); });
+        if (!converted) {
+            cerr << "cannot convert " << args[0] << endl;
+            return 1;
+        }
+        cout << "Wrote " << args[1] << " in " << ms << " ms" << endl;
+        return 0;
+    }
+
+    if (command == "info" && args.size() == 1) {
+        CSRGraph g;
+        if (!g.mapFile(args[0], options.count("--verify"))) {
+            cerr << "cannot map " << args[0] << endl;
+            return 1;
+        }
+        cout << args[0] << ": " << g.numVertices() << " vertices, " << g.numArcs() << " arcs, "
+             << (g.isDirected() ? "directed" : "undirected") << ", max weight " << g.maxWeight() << endl;
+        if (!g.isDirected()) cout << "Components: " << g.countComponents() << endl;
+        return 0;
+    }
+
+    cerr << "usage: " << argv[0] << " convert <edges.txt> <graph.csr> [--directed]\n"
+         << "       " << argv[0] << " info <graph.csr> [--verify]\n";
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) return runGraphTool(argc, argv);
+    cout << "=== Undirected Graph ===\n";
+    Graph g1(6);
+    g1.addEdge(0, 1);
+    g1.addEdge(0, 2);
+    g1.addEdge(1, 3);
+    g1.addEdge(2, 3);
+    g1.addEdge(3, 4);
+    g1.addEdge(4, 5);
+    g1.print();
+
+    g1.BFS(0);
+    g1.DFS(0);
+    g1.DFSIterative(0);
+
+    cout << "Has cycle: " << (g1.hasCycleUndirected() ? "Yes" : "No") << endl;
+    cout << "Is bipartite: " << (g1.isBipartite() ? "Yes" : "No") << endl;
+
+    cout << "\n=== Directed Weighted Graph ===\n";
+    Graph g2(5, true);
+    g2.addEdge(0, 1, 4);
+    g2.addEdge(0, 2, 1);
+    g2.addEdge(2, 1, 2);
+    g2.addEdge(1, 3, 1);
+    g2.addEdge(2, 3, 5);
+    g2.addEdge(3, 4, 3);
+    g2.print();
+
+    vector<int> dist = g2.dijkstra(0);
+    cout << "Dijkstra from 0: ";
+    for (int i = 0; i < 5; i++) {
+        cout << "to " << i << "=" << dist[i] << " ";
+    }
+    cout << endl;
+
+    cout << "\n=== DAG Topological Sort ===\n";
+    Graph g3(6, true);
+    g3.addEdge(5, 2);
+    g3.addEdge(5, 0);
+    g3.addEdge(4, 0);
+    g3.addEdge(4, 1);
+    g3.addEdge(2, 3);
+    g3.addEdge(3, 1);
+    g3.topologicalSort();
+
+    cout << "\n=== CSR Graph ===\n";
+    CSRGraph c1(g1);  // Same arcs as g1
+    cout << "BFS: ";
+    for (int u : c1.BFS(0)) cout << u << " ";
+    cout << endl;
+    cout << "Components: " << c1.countComponents() << endl;  // 1
+    cout << "Is bipartite: " << (c1.isBipartite() ? "Yes" : "No") << endl;
+
+    vector<Edge> edges = {{0, 1, 4}, {0, 2, 1}, {2, 1, 2}, {1, 3, 1}, {2, 3, 5}, {3, 4, 3}};
+    CSRGraph c2(5, edges, true);  // Same edges as g2
+    vector<int> csrDist = c2.dijkstra(0);
+    cout << "Dijkstra from 0: ";
+    for (int i = 0; i < 5; i++) {
+        cout << "to " << i << "=" << csrDist[i] << " ";
+    }
+    cout << endl;
+
+    cout << "\n=== Benchmark: Adjacency List vs CSR ===\n";
+    benchmarkCSR(200000, 2000000);
+
+    cout << "\n=== Direction-Optimizing Parallel BFS ===\n";
+    BFSResult bfs = parallelBFS(c1, 0, 2);
+    cout << "Distances from 0: ";
+    for (int d : bfs.dist) cout << d << " ";
+    cout << endl;
+    benchmarkParallelBFS(20, 16);
+    benchmarkParallelForOverhead(4, 2000);
+
+    cout << "\n=== Delta-Stepping SSSP ===\n";
+    vector<int> deltaDist = deltaStepping(c2, 0, 2);
+    cout << "Dijkstra from 0: ";
+    for (int i = 0; i < 5; i++) {
+        cout << "to " << i << "=" << deltaDist[i] << " ";
+    }
+    cout << endl;
+    benchmarkDeltaStepping();
+
+    cout << "\n=== Dial / Radix Heap Dijkstra ===\n";
+    vector<int> radixDist = integerDijkstra(c2, 0, DijkstraQueue::Radix);
+    cout << "Dijkstra from 0: ";
+    for (int i = 0; i < 5; i++) {
+        cout << "to " << i << "=" << radixDist[i] << " ";
+    }
+    cout << endl;
+    benchmarkIntegerDijkstra();
+
+    cout << "\n=== Point-to-Point Queries ===\n";
+    PointToPointEngine p2p(c2);
+    PathQuery q = p2p.bidirectional(0, 4);
+    cout << "Bidirectional 0 -> 4: " << q.dist << " (" << q.settled << " settled)" << endl;  // 7
+    q = p2p.astar(0, 4, [](int, int) { return 0; });  // h = 0 is plain Dijkstra
+    cout << "A* 0 -> 4: " << q.dist << " (" << q.settled << " settled)" << endl;
+    benchmarkPointToPoint(300, 300, 100);
+
+    cout << "\n=== Contraction Hierarchies ===\n";
+    ContractionHierarchy ch(c2);
+    q = ch.query(0, 4);
+    cout << "CH 0 -> 4: " << q.dist << " (" << q.settled << " settled, "
+         << ch.numShortcuts() << " shortcuts)" << endl;  // 7
+    benchmarkContractionHierarchy(1000);
+
+    cout << "\n=== Iterative DFS Family ===\n";
+    CSRGraph c3(g3);
+    DepthFirstSearch dfs(c3);
+    cout << "Topological Sort: ";
+    for (int u : dfs.topologicalSort()) cout << u << " ";  // Same as g3.topologicalSort()
+    cout << endl;
+    cout << "Has cycle: " << (dfs.hasCycleDirected() ? "Yes" : "No") << endl;
+    cout << "SCCs: " << dfs.stronglyConnectedComponents() << endl;  // 6
+    benchmarkDFS(2000000);
+
+    cout << "\n=== Parallel Connected Components ===\n";
+    Graph forest(7);
+    forest.addEdge(0, 1);
+    forest.addEdge(1, 2);
+    forest.addEdge(3, 4);
+    forest.addEdge(5, 6);
+    ComponentResult cc = parallelComponents(CSRGraph(forest));
+    cout << "Components: " << cc.count << " (list: " << forest.countComponents() << ")\nLabels: ";  // 3
+    for (int l : cc.label) cout << l << " ";  // 0 0 0 3 3 5 5
+    cout << endl;
+    benchmarkComponents();
+
+    cout << "\n=== Dynamic Graph ===\n";
+    DynamicGraph dg(6);
+    dg.applyUpdates({{0, 1, 1}, {0, 2, 1}, {1, 3, 1}, {2, 3, 1}, {3, 4, 1}, {4, 5, 1}}, {});
+    dg.applyUpdates({{1, 4, 1}}, {{3, 4}});
+    cout << "Has edge 3-4: " << (dg.hasEdge(3, 4) ? "Yes" : "No") << endl;  // No
+    cout << "BFS: ";
+    for (int u : dg.BFS(0)) cout << u << " ";
+    cout << endl;
+    benchmarkDynamicGraph(18, 16, 100000);
+
+    cout << "\n=== CSR File (mmap) ===\n";
+    for (bool withChecksums : {true, false}) {
+        CSRGraph mappedGraph;
+        bool ok = c2.save("demo.csr", withChecksums) && mappedGraph.mapFile("demo.csr", true);
+        cout << "Save/map " << (withChecksums ? "with" : "without") << " checksums: " << (ok ? "OK" : "FAILED") << endl;
+        if (ok) {
+            cout << "Mapped: " << mappedGraph.numVertices() << " vertices, " << mappedGraph.numArcs() << " arcs\n";
+            cout << "Dijkstra from 0: ";
+            for (int d : mappedGraph.dijkstra(0)) cout << d << " ";  // 0 3 1 4 7
+            cout << endl;
+        }
+    }
+    remove("demo.csr");
+    benchmarkCSRFile(18, 16);
 
     return 0;
 }
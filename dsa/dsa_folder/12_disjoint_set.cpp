@@ -1,49 +1,75 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 using namespace std;
 
 // Disjoint Set Union (Union-Find)
+// Sets are also threaded on a circular "next" list, so the members of a set
+// can be listed in O(size) and two sets merge by swapping two next links.
 class DSU {
 private:
     vector<int> parent;
-    vector<int> rank_;
+    vector<int> size_;  // Valid at roots
+    vector<int> next_;  // Circular list through each set's members
     int components;
 
 public:
     DSU(int n) {
         parent.resize(n);
-        rank_.resize(n, 0);
+        size_.resize(n, 1);
+        next_.resize(n);
         components = n;
         for (int i = 0; i < n; i++) {
             parent[i] = i;  // Each element is its own parent
+            next_[i] = i;
         }
     }
 
     // Find with path compression - O(α(n)) ≈ O(1)
+    // Two passes instead of recursion, so long chains cannot overflow the stack
     int find(int x) {
-        if (parent[x] != x) {
-            parent[x] = find(parent[x]);  // Path compression
+        int root = x;
+        while (parent[root] != root) root = parent[root];
+        while (parent[x] != root) {
+            int next = parent[x];
+            parent[x] = root;  // Path compression
+            x = next;
         }
-        return parent[x];
+        return root;
+    }
+
+    // Root without path compression - read-only, so threads may call it
+    // concurrently while nobody unites
+    int root(int x) const {
+        while (parent[x] != x) x = parent[x];
+        return x;
     }
 
-    // Union by rank - O(α(n)) ≈ O(1)
-    void unite(int x, int y) {
+    // Union by size - O(α(n)) ≈ O(1). Returns false if already in the same set
+    bool unite(int x, int y) {
         int rootX = find(x);
         int rootY = find(y);
 
-        if (rootX == rootY) return;  // Already in same set
+        if (rootX == rootY) return false;  // Already in same set
 
-        // Union by rank
-        if (rank_[rootX] < rank_[rootY]) {
-            parent[rootX] = rootY;
-        } else if (rank_[rootX] > rank_[rootY]) {
-            parent[rootY] = rootX;
-        } else {
-            parent[rootY] = rootX;
-            rank_[rootX]++;
-        }
+        // Union by size: the smaller tree goes below the larger root
+        if (size_[rootX] < size_[rootY]) swap(rootX, rootY);
+        parent[rootY] = rootX;
+        size_[rootX] += size_[rootY];
+        swap(next_[rootX], next_[rootY]);  // Splice the two member lists
         components--;
+        return true;
     }
 
     // Check if connected - O(α(n))
@@ -54,17 +80,201 @@ public:
     // Get number of components
     int getComponents() { return components; }
 
-    // Get size of component containing x
+    // Get size of component containing x - O(α(n))
     int getSize(int x) {
-        int root = find(x);
-        int size = 0;
-        for (int i = 0; i < parent.size(); i++) {
-            if (find(i) == root) size++;
+        return size_[find(x)];
+    }
+
+    // Members of the set containing x - O(size), no find needed
+    vector<int> members(int x) const {
+        vector<int> out;
+        out.reserve(size_[root(x)]);
+        int y = x;
+        do {
+            out.push_back(y);
+            y = next_[y];
+        } while (y != x);
+        return out;
+    }
+
+    size_t memoryBytes() const { return parent.size() * 3 * sizeof(int); }
+};
+
+// Compact DSU: one 32-bit word per element instead of three
+// A root stores -size and every other element stores its parent, so the sign
+// bit tells them apart. Union by size, path halving. No member lists.
+class CompactDSU {
+private:
+    vector<int> link;
+    int components;
+
+public:
+    CompactDSU(int n) : link(n, -1), components(n) {}
+
+    // Find with path halving - O(α(n))
+    int find(int x) {
+        while (link[x] >= 0) {
+            int p = link[x];
+            if (link[p] < 0) return p;
+            link[x] = link[p];  // Skip to the grandparent
+            x = link[x];
+        }
+        return x;
+    }
+
+    bool unite(int x, int y) {
+        int rootX = find(x);
+        int rootY = find(y);
+        if (rootX == rootY) return false;
+        if (link[rootX] > link[rootY]) swap(rootX, rootY);  // rootX is the larger set
+        link[rootX] += link[rootY];
+        link[rootY] = rootX;
+        components--;
+        return true;
+    }
+
+    bool connected(int x, int y) { return find(x) == find(y); }
+    int getComponents() const { return components; }
+    int getSize(int x) { return -link[find(x)]; }
+    size_t memoryBytes() const { return link.size() * sizeof(int); }
+};
+
+// Rollback DSU: union by rank, no path compression
+// Without compression every unite changes at most one parent and one rank,
+// so each one is logged and can be undone exactly. Union by rank alone keeps
+// trees O(log n) deep, so find is O(log n).
+class RollbackDSU {
+private:
+    struct Change {
+        int child, root;    // parent[child] was set to root
+        bool rankRaised;    // rank_[root] was incremented
+    };
+    vector<int> parent;
+    vector<int> rank_;
+    vector<Change> history;
+    int components;
+
+public:
+    RollbackDSU(int n) : parent(n), rank_(n, 0), components(n) {
+        for (int i = 0; i < n; i++) parent[i] = i;
+    }
+
+    // Find without path compression - O(log n)
+    int find(int x) const {
+        while (parent[x] != x) x = parent[x];
+        return x;
+    }
+
+    // Union by rank - O(log n). Returns false if already in the same set
+    bool unite(int x, int y) {
+        int rootX = find(x);
+        int rootY = find(y);
+        if (rootX == rootY) return false;
+        if (rank_[rootX] < rank_[rootY]) swap(rootX, rootY);
+        bool raise = rank_[rootX] == rank_[rootY];
+        parent[rootY] = rootX;
+        if (raise) rank_[rootX]++;
+        history.push_back({rootY, rootX, raise});
+        components--;
+        return true;
+    }
+
+    bool connected(int x, int y) const { return find(x) == find(y); }
+    int getComponents() const { return components; }
+
+    // A snapshot is the length of the change log
+    int snapshot() const { return history.size(); }
+
+    // Undo every unite made after the snapshot - O(unites undone)
+    void rollback(int snap) {
+        while ((int)history.size() > snap) {
+            Change c = history.back();
+            history.pop_back();
+            parent[c.child] = c.child;
+            if (c.rankRaised) rank_[c.root]--;
+            components++;
         }
-        return size;
     }
 };
 
+// Lock-free concurrent DSU (Jayanti-Tarjan)
+// Any number of threads may call find, unite and connected at the same time.
+// A root is linked with one CAS on its parent slot, always below a root of
+// higher priority, so links never form a cycle; if the CAS loses a race the
+// roots are found again and the link retried. find compacts paths by
+// splitting: each visited node's parent is CAS'ed to its grandparent, and a
+// failed CAS just means another thread already shortened the path.
+// Priorities are either the element ids or a random permutation; random
+// linking keeps expected depth O(log n) even for adversarial union orders.
+class ConcurrentDSU {
+public:
+    enum class Linking { ByIndex, Random };
+
+private:
+    vector<atomic<int>> parent;
+    vector<uint32_t> priority;  // Empty when linking by index
+    atomic<int> components;
+
+    bool lower(int x, int y) const {
+        if (priority.empty()) return x < y;
+        return priority[x] < priority[y];  // A permutation, so never equal
+    }
+
+public:
+    ConcurrentDSU(int n, Linking linking = Linking::Random, uint64_t seed = 1)
+        : parent(n), components(n) {
+        for (int i = 0; i < n; i++) parent[i].store(i, memory_order_relaxed);
+        if (linking == Linking::Random) {
+            priority.resize(n);
+            for (int i = 0; i < n; i++) priority[i] = i;
+            uint64_t x = seed | 1;
+            for (int i = n - 1; i > 0; i--) {
+                x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                swap(priority[i], priority[x % (i + 1)]);
+            }
+        }
+    }
+
+    // Find with path splitting - lock-free
+    int find(int x) {
+        for (;;) {
+            int p = parent[x].load(memory_order_acquire);
+            int gp = parent[p].load(memory_order_acquire);
+            if (p == gp) return p;
+            parent[x].compare_exchange_weak(p, gp, memory_order_release, memory_order_relaxed);
+            x = p;
+        }
+    }
+
+    // Returns false if x and y were already in the same set
+    bool unite(int x, int y) {
+        for (;;) {
+            x = find(x);
+            y = find(y);
+            if (x == y) return false;
+            if (lower(y, x)) swap(x, y);
+            int expected = x;  // x must still be a root
+            if (parent[x].compare_exchange_strong(expected, y, memory_order_acq_rel)) {
+                components.fetch_sub(1, memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    // Linearizable: x and y are in different sets if x is still a root
+    // after both finds
+    bool connected(int x, int y) {
+        for (;;) {
+            x = find(x);
+            y = find(y);
+            if (x == y) return true;
+            if (parent[x].load(memory_order_acquire) == x) return false;
+        }
+    }
+
+    int getComponents() const { return components.load(memory_order_relaxed); }
+};
+
 // Kruskal's MST using DSU
 struct Edge {
     int u, v, weight;
@@ -73,26 +283,364 @@ struct Edge {
     }
 };
 
-int kruskalMST(int V, vector<Edge>& edges) {
+int kruskalMST(int V, vector<Edge>& edges, bool printEdges = true) {
     sort(edges.begin(), edges.end());
     DSU dsu(V);
     int mstWeight = 0;
     int edgesUsed = 0;
 
-    cout << "MST Edges: ";
+    if (printEdges) cout << "MST Edges: ";
     for (Edge& e : edges) {
         if (!dsu.connected(e.u, e.v)) {
             dsu.unite(e.u, e.v);
             mstWeight += e.weight;
             edgesUsed++;
-            cout << "(" << e.u << "-" << e.v << ":" << e.weight << ") ";
+            if (printEdges) cout << "(" << e.u << "-" << e.v << ":" << e.weight << ") ";
             if (edgesUsed == V - 1) break;
         }
     }
-    cout << endl;
+    if (printEdges) cout << endl;
     return mstWeight;
 }
 
+int defaultThreads() {
+    unsigned n = thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// Persistent worker threads for parallelFor. Workers start on first use and
+// sleep on a condition variable between jobs, so the several calls per
+// Borůvka round pay one wake-up each instead of creating and joining
+// threads every time.
+class WorkerPool {
+private:
+    mutex dispatchLock;  // One job at a time
+    mutex lock;
+    condition_variable wake, done;
+    vector<thread> workers;
+    void (*job)(void*, int) = nullptr;
+    void* context = nullptr;
+    int active = 0;      // Workers with tid <= active run the current job
+    int pending = 0;     // Of those, how many have not finished yet
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void loop(int tid) {
+        inWorker = true;
+        uint64_t seen = 0;
+        unique_lock<mutex> guard(lock);
+        for (;;) {
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (tid > active) continue;
+            guard.unlock();
+            job(context, tid);
+            guard.lock();
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+public:
+    inline static thread_local bool inWorker = false;  // Nested calls run inline
+
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    // Runs f(tid) for tid = 0..helpers: tid 0 on the calling thread, the
+    // rest on pool workers. Returns once all of them have finished.
+    template<typename F>
+    void run(int helpers, F& f) {
+        lock_guard<mutex> dispatch(dispatchLock);
+        {
+            lock_guard<mutex> guard(lock);
+            while ((int)workers.size() < helpers) {
+                int tid = workers.size() + 1;
+                workers.emplace_back([this, tid] { loop(tid); });
+            }
+            job = [](void* c, int tid) { (*(F*)c)(tid); };
+            context = &f;
+            active = pending = helpers;
+            generation++;
+        }
+        wake.notify_all();
+        inWorker = true;
+        f(0);
+        inWorker = false;
+        unique_lock<mutex> guard(lock);
+        done.wait(guard, [&] { return pending == 0; });
+    }
+};
+
+// Calls body(begin, end, tid) over [0, n) in chunks of `grain`, handed out
+// dynamically to `threads` threads from the WorkerPool. Runs inline when
+// there is only one chunk or when called from inside another parallelFor.
+template<typename F>
+void parallelFor(long long n, int threads, long long grain, F body) {
+    if (threads <= 1 || n <= grain || WorkerPool::inWorker) {
+        if (n > 0) body(0LL, n, 0);
+        return;
+    }
+    threads = (int)min<long long>(threads, (n + grain - 1) / grain);
+    atomic<long long> next(0);
+    auto worker = [&](int tid) {
+        for (;;) {
+            long long begin = next.fetch_add(grain);
+            if (begin >= n) break;
+            body(begin, min(n, begin + grain), tid);
+        }
+    };
+    WorkerPool::instance().run(threads - 1, worker);
+}
+
+// Minimum spanning forest: the chosen edges and their total weight
+struct MSTResult {
+    vector<Edge> edges;
+    long long totalWeight = 0;
+};
+
+// Parallel Borůvka - O(E log V)
+// Each round every component picks its lightest crossing edge (atomic min on
+// a (weight, position) key, so ties are broken consistently), hooks along it
+// and collapses by pointer jumping. The working arcs are then relabeled to
+// component ids and arcs inside a component are dropped, so later rounds
+// only touch the shrinking set of live components. Arcs carry 32-bit edge
+// positions and the all-ones key marks "no edge", so E must stay below
+// 2^32 - 1; larger inputs throw length_error.
+MSTResult boruvkaMST(int V, const vector<Edge>& edges, int threads = defaultThreads()) {
+    if (edges.size() >= UINT32_MAX) throw length_error("boruvkaMST: edge count must be below 2^32 - 1");
+    struct Arc { int u, v, weight; uint32_t index; };  // Endpoints are component ids
+    const uint64_t NONE = UINT64_MAX;
+    const long long GRAIN = 1 << 14;
+    int T = max(threads, 1);
+
+    vector<Arc> arcs(edges.size());
+    vector<atomic<int>> parent(V);
+    vector<atomic<uint64_t>> best(V);
+    vector<int> roots(V);
+    for (int v = 0; v < V; v++) {
+        roots[v] = v;
+        parent[v].store(v, memory_order_relaxed);
+    }
+    parallelFor(arcs.size(), T, GRAIN, [&](long long b, long long e, int) {
+        for (long long i = b; i < e; i++) arcs[i] = {edges[i].u, edges[i].v, edges[i].weight, (uint32_t)i};
+    });
+
+    // Compact arcs in place: each chunk packs its survivors, then the chunks slide together
+    auto compact = [&](long long n, auto keep) {
+        long long grain = max<long long>(GRAIN, (n + T - 1) / T);
+        vector<long long> kept((n + grain - 1) / grain);
+        parallelFor(n, T, grain, [&](long long b, long long e, int) {
+            long long out = b;
+            for (long long i = b; i < e; i++) {
+                if (keep(arcs[i])) arcs[out++] = arcs[i];
+            }
+            kept[b / grain] = out - b;
+        });
+        long long total = 0;
+        for (size_t c = 0; c < kept.size(); c++) {
+            memmove(&arcs[total], &arcs[c * grain], kept[c] * sizeof(Arc));
+            total += kept[c];
+        }
+        return total;
+    };
+    long long n = compact(arcs.size(), [](Arc& a) { return a.u != a.v; });  // Self-loops
+
+    vector<vector<Edge>> picked(T);
+    while (n > 0) {
+        long long R = roots.size();
+        parallelFor(R, T, GRAIN, [&](long long b, long long e, int) {
+            for (long long i = b; i < e; i++) best[roots[i]].store(NONE, memory_order_relaxed);
+        });
+        parallelFor(n, T, GRAIN, [&](long long b, long long e, int) {
+            for (long long i = b; i < e; i++) {
+                uint64_t key = (uint64_t)((uint32_t)arcs[i].weight ^ 0x80000000u) << 32 | i;
+                for (int c : {arcs[i].u, arcs[i].v}) {
+                    uint64_t old = best[c].load(memory_order_relaxed);
+                    while (key < old && !best[c].compare_exchange_weak(old, key, memory_order_relaxed)) {}
+                }
+            }
+        });
+
+        // Hook each component to the other end of its lightest arc. Keys are
+        // distinct, so the only cycles are pairs that chose the same arc; the
+        // smaller id stays the root and the edge is taken once.
+        parallelFor(R, T, GRAIN, [&](long long b, long long e, int tid) {
+            for (long long i = b; i < e; i++) {
+                int c = roots[i];
+                uint64_t key = best[c].load(memory_order_relaxed);
+                if (key == NONE) continue;
+                const Arc& a = arcs[(uint32_t)key];
+                int other = a.u == c ? a.v : a.u;
+                if (best[other].load(memory_order_relaxed) == key && c < other) continue;
+                parent[c].store(other, memory_order_relaxed);
+                picked[tid].push_back(edges[a.index]);
+            }
+        });
+
+        for (bool changed = true; changed;) {
+            atomic<bool> jumped(false);
+            parallelFor(R, T, GRAIN, [&](long long b, long long e, int) {
+                bool any = false;
+                for (long long i = b; i < e; i++) {
+                    int p = parent[roots[i]].load(memory_order_relaxed);
+                    int gp = parent[p].load(memory_order_relaxed);
+                    if (p != gp) {
+                        parent[roots[i]].store(gp, memory_order_relaxed);
+                        any = true;
+                    }
+                }
+                if (any) jumped.store(true, memory_order_relaxed);
+            });
+            changed = jumped.load();
+        }
+
+        n = compact(n, [&](Arc& a) {
+            a.u = parent[a.u].load(memory_order_relaxed);
+            a.v = parent[a.v].load(memory_order_relaxed);
+            return a.u != a.v;
+        });
+        roots.erase(remove_if(roots.begin(), roots.end(),
+                              [&](int c) { return parent[c].load(memory_order_relaxed) != c; }),
+                    roots.end());
+    }
+
+    MSTResult r;
+    for (auto& p : picked) {
+        for (const Edge& e : p) r.totalWeight += e.weight;
+        r.edges.insert(r.edges.end(), p.begin(), p.end());
+    }
+    return r;
+}
+
+// Filter-Kruskal (Osipov, Sanders, Singler)
+// Quicksort-style: split the edges at a sampled pivot weight, solve the light
+// half first, then drop heavy edges whose endpoints are already connected
+// before recursing on them. Most heavy edges are filtered out instead of
+// sorted. Partition and filter run in parallel; small ranges use plain Kruskal.
+class FilterKruskal {
+private:
+    int V, threads;
+    DSU dsu;
+    MSTResult result;
+    vector<Edge> scratch;  // Partition buffer, only for threads > 1
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+    bool done() const { return (int)result.edges.size() == V - 1; }
+    long long baseCase() const { return max(V, 1 << 16); }
+
+    void kruskal(Edge* begin, Edge* end) {
+        sort(begin, end);
+        for (Edge* e = begin; e != end && !done(); e++) {
+            if (dsu.unite(e->u, e->v)) {
+                result.edges.push_back(*e);
+                result.totalWeight += e->weight;
+            }
+        }
+    }
+
+    // Median of a small random sample
+    int pivotWeight(Edge* begin, long long n) {
+        int sample[15];
+        for (int& w : sample) {
+            rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+            w = begin[rng % n].weight;
+        }
+        nth_element(sample, sample + 7, sample + 15);
+        return sample[7];
+    }
+
+    // Stable partition into scratch by per-chunk counts, then copied back
+    template<typename Pred>
+    long long partitionEdges(Edge* begin, long long n, Pred left) {
+        if (threads <= 1) return std::partition(begin, begin + n, left) - begin;
+        long long grain = (n + threads - 1) / threads;
+        vector<long long> leftCount(threads + 1, 0), rightCount(threads + 1, 0);
+        parallelFor(n, threads, grain, [&](long long b, long long e, int) {
+            long long c = 0;
+            for (long long i = b; i < e; i++) c += left(begin[i]);
+            leftCount[b / grain + 1] = c;
+            rightCount[b / grain + 1] = (e - b) - c;
+        });
+        for (int t = 0; t < threads; t++) leftCount[t + 1] += leftCount[t];
+        long long split = leftCount[threads];
+        for (int t = 0; t < threads; t++) rightCount[t + 1] += rightCount[t];
+        parallelFor(n, threads, grain, [&](long long b, long long e, int) {
+            long long l = leftCount[b / grain], r = split + rightCount[b / grain];
+            for (long long i = b; i < e; i++) scratch[left(begin[i]) ? l++ : r++] = begin[i];
+        });
+        parallelFor(n, threads, grain, [&](long long b, long long e, int) {
+            copy(scratch.begin() + b, scratch.begin() + e, begin + b);
+        });
+        return split;
+    }
+
+    // Keep only edges that still join two components
+    long long filter(Edge* begin, long long n) {
+        if (threads <= 1) {
+            return std::remove_if(begin, begin + n, [&](const Edge& e) { return dsu.find(e.u) == dsu.find(e.v); }) - begin;
+        }
+        long long grain = (n + threads - 1) / threads;
+        vector<long long> kept(threads, 0);
+        parallelFor(n, threads, grain, [&](long long b, long long e, int) {
+            long long out = b;
+            for (long long i = b; i < e; i++) {
+                if (dsu.root(begin[i].u) != dsu.root(begin[i].v)) begin[out++] = begin[i];
+            }
+            kept[b / grain] = out - b;
+        });
+        long long total = 0;
+        for (int t = 0; t < threads && t * grain < n; t++) {
+            memmove(begin + total, begin + t * grain, kept[t] * sizeof(Edge));
+            total += kept[t];
+        }
+        return total;
+    }
+
+    void solve(Edge* begin, long long n) {
+        if (done()) return;
+        if (n <= baseCase()) {
+            kruskal(begin, begin + n);
+            return;
+        }
+        int pivot = pivotWeight(begin, n);
+        long long split = partitionEdges(begin, n, [pivot](const Edge& e) { return e.weight < pivot; });
+        if (split == 0) split = partitionEdges(begin, n, [pivot](const Edge& e) { return e.weight <= pivot; });
+        if (split == n) {  // Every weight equals the pivot
+            kruskal(begin, begin + n);
+            return;
+        }
+        solve(begin, split);
+        if (done()) return;
+        solve(begin + split, filter(begin + split, n - split));
+    }
+
+public:
+    FilterKruskal(int vertices, int threads) : V(vertices), threads(max(threads, 1)), dsu(vertices) {}
+
+    // Reorders edges, like kruskalMST
+    MSTResult run(vector<Edge>& edges) {
+        if (threads > 1) scratch.resize(edges.size());
+        solve(edges.data(), edges.size());
+        return result;
+    }
+};
+
+MSTResult filterKruskalMST(int V, vector<Edge>& edges, int threads = defaultThreads()) {
+    return FilterKruskal(V, threads).run(edges);
+}
+
 // Detect cycle in undirected graph using DSU
 bool hasCycle(int V, vector<pair<int,int>>& edges) {
     DSU dsu(V);
@@ -105,7 +653,281 @@ bool hasCycle(int V, vector<pair<int,int>>& edges) {
     return false;
 }
 
-int main() {
+// Offline dynamic connectivity (segment tree over time)
+// Every edge is alive for an interval of queries, from its Add to its Remove
+// (or the end). Each interval is stored at the O(log Q) segment tree nodes
+// that cover it. A depth-first walk of the tree unites a node's edges on the
+// way down and rolls them back on the way up, so at leaf i the DSU holds
+// exactly the edges alive at query i. O((E log Q + Q) log n) overall.
+struct ConnectivityOp {
+    enum Type { Add, Remove, Connected, Components } type;
+    int u, v;  // Unused by Components
+};
+
+class OfflineConnectivity {
+private:
+    RollbackDSU dsu;
+    vector<vector<pair<int, int>>> tree;  // Edges alive over each node's whole range
+    vector<const ConnectivityOp*> queries;
+    vector<int> answers;
+
+    void insert(int node, int l, int r, int from, int to, pair<int, int> edge) {
+        if (to <= l || r <= from) return;
+        if (from <= l && r <= to) {
+            tree[node].push_back(edge);
+            return;
+        }
+        int mid = (l + r) / 2;
+        insert(2 * node, l, mid, from, to, edge);
+        insert(2 * node + 1, mid, r, from, to, edge);
+    }
+
+    void walk(int node, int l, int r) {
+        int snap = dsu.snapshot();
+        for (auto& e : tree[node]) dsu.unite(e.first, e.second);
+        if (r - l == 1) {
+            const ConnectivityOp& q = *queries[l];
+            answers[l] = q.type == ConnectivityOp::Connected ? dsu.connected(q.u, q.v) : dsu.getComponents();
+        } else {
+            int mid = (l + r) / 2;
+            walk(2 * node, l, mid);
+            walk(2 * node + 1, mid, r);
+        }
+        dsu.rollback(snap);
+    }
+
+public:
+    OfflineConnectivity(int n) : dsu(n) {}
+
+    // One answer per query op, in order: 1/0 for Connected, the count for
+    // Components. Edges are undirected multiset entries; removing an edge
+    // that is not present is ignored.
+    vector<int> solve(const vector<ConnectivityOp>& ops) {
+        queries.clear();
+        for (auto& op : ops) {
+            if (op.type == ConnectivityOp::Connected || op.type == ConnectivityOp::Components) queries.push_back(&op);
+        }
+        int Q = queries.size();
+        answers.assign(Q, 0);
+        if (Q == 0) return answers;
+        tree.assign(4 * Q, {});
+
+        map<pair<int, int>, vector<int>> open;  // Edge -> query index at each live Add
+        int seen = 0;
+        for (auto& op : ops) {
+            pair<int, int> edge = {min(op.u, op.v), max(op.u, op.v)};
+            if (op.type == ConnectivityOp::Add) {
+                open[edge].push_back(seen);
+            } else if (op.type == ConnectivityOp::Remove) {
+                auto it = open.find(edge);
+                if (it == open.end()) continue;
+                insert(1, 0, Q, it->second.back(), seen, edge);
+                it->second.pop_back();
+                if (it->second.empty()) open.erase(it);
+            } else {
+                seen++;
+            }
+        }
+        for (auto& entry : open) {
+            for (int from : entry.second) insert(1, 0, Q, from, Q, entry.first);
+        }
+        walk(1, 0, Q);
+        return answers;
+    }
+};
+
+// Random graph: m edges with uniform endpoints, weights 1..maxWeight
+vector<Edge> randomEdges(int V, long long m, int maxWeight, uint64_t seed) {
+    vector<Edge> edges(m);
+    uint64_t x = seed | 1;
+    auto next = [&] {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        return x;
+    };
+    for (auto& e : edges) {
+        e.u = next() % V;
+        e.v = next() % V;
+        e.weight = 1 + next() % maxWeight;
+    }
+    return edges;
+}
+
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Benchmark: kruskalMST vs Filter-Kruskal vs Borůvka on a random graph.
+// Each run gets a fresh copy of the edges (not timed), since Kruskal sorts in place.
+void benchmarkMST(int V, long long m) {
+    vector<Edge> edges = randomEdges(V, m, 1000, 7);
+    vector<Edge> work;
+    long long expected = 0;
+    printf("  %d vertices, %lld edges (%.1f GB)\n", V, m, m * sizeof(Edge) / 1e9);
+    printf("  %-22s %10s %14s\n", "", "time (ms)", "total weight");
+
+    work = edges;
+    double t = timeMs([&] { expected = kruskalMST(V, work, false); });
+    printf("  %-22s %10.0f %14lld\n", "kruskalMST", t, expected);
+
+    for (int threads = 1;; threads = min(threads * 2, defaultThreads())) {
+        char label[40];
+        MSTResult r;
+        work = edges;
+        t = timeMs([&] { r = filterKruskalMST(V, work, threads); });
+        snprintf(label, sizeof(label), "Filter-Kruskal x%d", threads);
+        printf("  %-22s %10.0f %14lld%s\n", label, t, r.totalWeight, r.totalWeight == expected ? "" : "  MISMATCH");
+        vector<Edge>().swap(work);
+
+        t = timeMs([&] { r = boruvkaMST(V, edges, threads); });
+        snprintf(label, sizeof(label), "Boruvka x%d", threads);
+        printf("  %-22s %10.0f %14lld%s\n", label, t, r.totalWeight, r.totalWeight == expected ? "" : "  MISMATCH");
+        if (threads == defaultThreads()) break;
+    }
+}
+
+// Benchmark: DSU vs CompactDSU, and getSize against the old full scan
+void benchmarkDSULayouts(int n, long long ops) {
+    vector<Edge> pairs = randomEdges(n, ops, 1, 5);
+    DSU dsu(n);
+    CompactDSU compact(n);
+    double uniteMs = timeMs([&] { for (auto& p : pairs) dsu.unite(p.u, p.v); });
+    double compactMs = timeMs([&] { for (auto& p : pairs) compact.unite(p.u, p.v); });
+    long long total = 0, compactTotal = 0;
+    double sizeMs = timeMs([&] { for (auto& p : pairs) total += dsu.getSize(p.u); });
+    double compactSizeMs = timeMs([&] { for (auto& p : pairs) compactTotal += compact.getSize(p.u); });
+
+    // The old getSize: one find per element
+    const int SCANS = 5;
+    long long scanned = 0;
+    double scanMs = timeMs([&] {
+        for (int i = 0; i < SCANS; i++) {
+            int root = dsu.find(pairs[i].u);
+            for (int x = 0; x < n; x++) scanned += dsu.find(x) == root;
+        }
+    });
+    int largest = 0;
+    for (int x = 0; x < n; x++) if (dsu.getSize(x) > dsu.getSize(largest)) largest = x;
+    size_t listed = 0;
+    double membersMs = timeMs([&] { listed = dsu.members(largest).size(); });
+
+    auto ns = [](double ms, long long count) { return ms * 1e6 / count; };
+    printf("  %d elements, %lld random unites\n", n, ops);
+    printf("  %-12s %14s %14s %10s\n", "", "unite ns/op", "getSize ns/op", "bytes/elem");
+    printf("  %-12s %14.1f %14.1f %10.0f\n", "DSU", ns(uniteMs, ops), ns(sizeMs, ops), (double)dsu.memoryBytes() / n);
+    printf("  %-12s %14.1f %14.1f %10.0f%s\n", "CompactDSU", ns(compactMs, ops), ns(compactSizeMs, ops),
+           (double)compact.memoryBytes() / n, total == compactTotal ? "" : "  MISMATCH");
+    printf("  getSize by scan (old): %.1f ms per call\n", scanMs / SCANS);
+    printf("  members() of the largest set: %zu elements in %.1f ms (size %d)\n", listed, membersMs, dsu.getSize(largest));
+}
+
+// Benchmark: DSU vs ConcurrentDSU throughput. Each thread takes a slice of
+// the same random unites, then of the same random connected() queries.
+void benchmarkConcurrentDSU(int n, long long ops) {
+    vector<Edge> pairs = randomEdges(n, ops, 1, 3);
+    auto mops = [&](double ms) { return ops / ms / 1e3; };
+    long long hits = 0;
+    DSU serial(n);
+    double uniteMs = timeMs([&] { for (auto& p : pairs) serial.unite(p.u, p.v); });
+    double queryMs = timeMs([&] { for (auto& p : pairs) hits += serial.connected(p.u, p.v + 1 == n ? 0 : p.v + 1); });
+    printf("  %d elements, %lld unites + %lld queries\n", n, ops, ops);
+    printf("  %-22s %12s %12s %12s\n", "", "unite Mops/s", "query Mops/s", "components");
+    printf("  %-22s %12.1f %12.1f %12d\n", "DSU", mops(uniteMs), mops(queryMs), serial.getComponents());
+
+    for (auto linking : {ConcurrentDSU::Linking::ByIndex, ConcurrentDSU::Linking::Random}) {
+        for (int threads = 1;; threads = min(threads * 2, defaultThreads())) {
+            ConcurrentDSU dsu(n, linking);
+            atomic<long long> found(0);
+            uniteMs = timeMs([&] {
+                parallelFor(ops, threads, 1 << 16, [&](long long b, long long e, int) {
+                    for (long long i = b; i < e; i++) dsu.unite(pairs[i].u, pairs[i].v);
+                });
+            });
+            queryMs = timeMs([&] {
+                parallelFor(ops, threads, 1 << 16, [&](long long b, long long e, int) {
+                    long long local = 0;
+                    for (long long i = b; i < e; i++) local += dsu.connected(pairs[i].u, pairs[i].v + 1 == n ? 0 : pairs[i].v + 1);
+                    found += local;
+                });
+            });
+            char label[40];
+            snprintf(label, sizeof(label), "Concurrent %s x%d", linking == ConcurrentDSU::Linking::Random ? "random" : "index", threads);
+            bool same = dsu.getComponents() == serial.getComponents() && found == hits;
+            printf("  %-22s %12.1f %12.1f %12d%s\n", label, mops(uniteMs), mops(queryMs), dsu.getComponents(),
+                   same ? "" : "  MISMATCH");
+            if (threads == defaultThreads()) break;
+        }
+    }
+}
+
+// Benchmark: offline solver vs rebuilding a DSU from the live edges at every
+// query. The rebuild only runs the first NAIVE_OPS operations.
+void benchmarkOfflineConnectivity(int n, int opCount) {
+    const int NAIVE_OPS = 20000;
+    vector<ConnectivityOp> ops;
+    vector<pair<int, int>> live;
+    uint64_t x = 11;
+    auto next = [&] {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        return x;
+    };
+    for (int i = 0; i < opCount; i++) {
+        int r = next() % 10;
+        if (r < 4 || live.empty()) {
+            live.push_back({(int)(next() % n), (int)(next() % n)});
+            ops.push_back({ConnectivityOp::Add, live.back().first, live.back().second});
+        } else if (r < 7) {
+            size_t k = next() % live.size();
+            ops.push_back({ConnectivityOp::Remove, live[k].first, live[k].second});
+            live[k] = live.back();
+            live.pop_back();
+        } else if (r < 9) {
+            ops.push_back({ConnectivityOp::Connected, (int)(next() % n), (int)(next() % n)});
+        } else {
+            ops.push_back({ConnectivityOp::Components, 0, 0});
+        }
+    }
+
+    vector<int> answers;
+    double offlineMs = timeMs([&] { answers = OfflineConnectivity(n).solve(ops); });
+
+    vector<int> naive;
+    double naiveMs = timeMs([&] {
+        vector<pair<int, int>> edges;
+        for (int i = 0; i < NAIVE_OPS && i < opCount; i++) {
+            const ConnectivityOp& op = ops[i];
+            if (op.type == ConnectivityOp::Add) {
+                edges.push_back({op.u, op.v});
+            } else if (op.type == ConnectivityOp::Remove) {
+                for (auto& e : edges) {
+                    if ((e.first == op.u && e.second == op.v) || (e.first == op.v && e.second == op.u)) {
+                        e = edges.back();
+                        edges.pop_back();
+                        break;
+                    }
+                }
+            } else {
+                DSU dsu(n);
+                for (auto& e : edges) dsu.unite(e.first, e.second);
+                naive.push_back(op.type == ConnectivityOp::Connected ? dsu.connected(op.u, op.v) : dsu.getComponents());
+            }
+        }
+    });
+    bool same = equal(naive.begin(), naive.end(), answers.begin());
+    printf("  %d vertices, %d ops, %zu queries\n", n, opCount, answers.size());
+    printf("  offline solver:     %8.0f ms  (%.2f us per op)\n", offlineMs, offlineMs * 1e3 / opCount);
+    printf("  rebuild per query:  %8.0f ms  (%.2f us per op, first %d ops); answers %s\n", naiveMs,
+           naiveMs * 1e3 / min(NAIVE_OPS, opCount), NAIVE_OPS, same ? "match" : "DIFFER");
+}
+
+// Command line: 12_disjoint_set mst <vertices> <edges>
+int main(int argc, char** argv) {
+    if (argc == 4 && string(argv[1]) == "mst") {
+        benchmarkMST(atoi(argv[2]), atoll(argv[3]));
+        return 0;
+    }
     cout << "=== Disjoint Set Union ===\n";
     DSU dsu(7);
 
@@ -125,6 +947,60 @@ int main() {
     cout << "0 and 6 connected: " << (dsu.connected(0, 6) ? "Yes" : "No") << endl;  // Yes
     cout << "Components: " << dsu.getComponents() << endl;  // 1
 
+    cout << "\n=== Set Sizes and Members ===\n";
+    DSU groups(6);
+    groups.unite(0, 2);
+    groups.unite(2, 4);
+    groups.unite(1, 5);
+    cout << "Size of 4's set: " << groups.getSize(4) << endl;  // 3
+    cout << "Members of 0's set: ";
+    for (int x : groups.members(0)) cout << x << " ";  // 0 4 2
+    cout << endl;
+    CompactDSU packed(6);
+    packed.unite(0, 2);
+    packed.unite(2, 4);
+    cout << "Compact size of 0's set: " << packed.getSize(0) << endl;  // 3
+    benchmarkDSULayouts(1 << 22, 1 << 22);
+
+    cout << "\n=== Rollback DSU ===\n";
+    RollbackDSU history(5);
+    history.unite(0, 1);
+    int snap = history.snapshot();
+    history.unite(1, 2);
+    history.unite(3, 4);
+    cout << "Components: " << history.getComponents() << endl;  // 2
+    history.rollback(snap);
+    cout << "After rollback, 0 and 2 connected: " << (history.connected(0, 2) ? "Yes" : "No") << endl;  // No
+    cout << "Components: " << history.getComponents() << endl;  // 4
+
+    cout << "\n=== Offline Dynamic Connectivity ===\n";
+    vector<ConnectivityOp> timeline = {
+        {ConnectivityOp::Add, 0, 1}, {ConnectivityOp::Add, 1, 2},
+        {ConnectivityOp::Connected, 0, 2},   // 1
+        {ConnectivityOp::Remove, 1, 2},
+        {ConnectivityOp::Connected, 0, 2},   // 0
+        {ConnectivityOp::Add, 2, 0},
+        {ConnectivityOp::Components, 0, 0},  // 2 ({0,1,2}, {3})
+    };
+    cout << "Answers: ";
+    for (int a : OfflineConnectivity(4).solve(timeline)) cout << a << " ";  // 1 0 2
+    cout << endl;
+    benchmarkOfflineConnectivity(100000, 1000000);
+
+    cout << "\n=== Concurrent DSU ===\n";
+    ConcurrentDSU shared(7);
+    vector<thread> workers;
+    for (int t = 0; t < 3; t++) {
+        workers.emplace_back([&shared, t] {
+            shared.unite(2 * t, 2 * t + 1);  // {0,1} {2,3} {4,5}
+            shared.unite(2 * t + 1, 6);      // All joined through 6
+        });
+    }
+    for (auto& w : workers) w.join();
+    cout << "0 and 5 connected: " << (shared.connected(0, 5) ? "Yes" : "No") << endl;  // Yes
+    cout << "Components: " << shared.getComponents() << endl;  // 1
+    benchmarkConcurrentDSU(1 << 22, 1 << 23);
+
     cout << "\n=== Kruskal's MST ===\n";
     vector<Edge> edges = {
         {0, 1, 4}, {0, 7, 8}, {1, 2, 8}, {1, 7, 11},
@@ -134,6 +1010,12 @@ int main() {
     int mstWeight = kruskalMST(9, edges);
     cout << "MST Weight: " << mstWeight << endl;  // 37
 
+    MSTResult boruvka = boruvkaMST(9, edges);
+    MSTResult filtered = filterKruskalMST(9, edges);
+    cout << "Boruvka: " << boruvka.edges.size() << " edges, weight " << boruvka.totalWeight << endl;  // 8 edges, 37
+    cout << "Filter-Kruskal: " << filtered.edges.size() << " edges, weight " << filtered.totalWeight << endl;  // 8 edges, 37
+    benchmarkMST(1 << 20, 10000000);
+
     cout << "\n=== Cycle Detection ===\n";
     vector<pair<int,int>> graphEdges1 = {{0, 1}, {1, 2}, {2, 0}};
     cout << "Graph 1 has cycle: " << (hasCycle(3, graphEdges1) ? "Yes" : "No") << endl;  // Yes
@@ -1,6 +1,12 @@
 #include <iostream>
 #include <vector>
 #include <climits>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <numeric>
 using namespace std;
 
 // Segment Tree for Range Sum Queries
@@ -60,6 +66,8 @@ public:
     int query(int l, int r) {
         return query(1, 0, n-1, l, r);
     }
+
+    size_t memoryBytes() const { return (tree.size() + lazy.size()) * sizeof(int); }
 };
 
 // Segment Tree for Range Min Queries
@@ -107,6 +115,8 @@ public:
 
     void update(int idx, int val) { update(1, 0, n-1, idx, val); }
     int query(int l, int r) { return query(1, 0, n-1, l, r); }
+
+    size_t memoryBytes() const { return tree.size() * sizeof(int); }
 };
 
 // Segment Tree with Lazy Propagation (Range Update)
@@ -159,6 +169,141 @@ public:
     long long query(int l, int r) { return query(1, 0, n-1, l, r); }
 };
 
+// Monoids for IterativeSegmentTree: an identity and an associative combine
+template<typename T>
+struct SumMonoid {
+    static T identity() { return T(0); }
+    static T combine(const T& a, const T& b) { return a + b; }
+};
+
+template<typename T>
+struct MinMonoid {
+    static T identity() { return numeric_limits<T>::max(); }
+    static T combine(const T& a, const T& b) { return min(a, b); }
+};
+
+template<typename T>
+struct MaxMonoid {
+    static T identity() { return numeric_limits<T>::lowest(); }
+    static T combine(const T& a, const T& b) { return max(a, b); }
+};
+
+template<typename T>
+struct GcdMonoid {
+    static T identity() { return T(0); }  // gcd(0, x) = x
+    static T combine(const T& a, const T& b) { return gcd(a, b); }
+};
+
+// Bottom-up Segment Tree (non-recursive, 2n nodes)
+// Leaves live at tree[n .. 2n) and node i combines children 2i and 2i+1, so
+// there is no recursion and no 4n padding. Works for any n, not just powers
+// of two. Queries keep separate left and right accumulators, so the monoid
+// does not need to be commutative.
+template<typename T, typename Monoid>
+class IterativeSegmentTree {
+private:
+    int n;
+    vector<T> tree;
+
+public:
+    IterativeSegmentTree(const vector<T>& arr) : n(arr.size()), tree(2 * arr.size(), Monoid::identity()) {
+        copy(arr.begin(), arr.end(), tree.begin() + n);
+        for (int i = n - 1; i > 0; i--) tree[i] = Monoid::combine(tree[2 * i], tree[2 * i + 1]);
+    }
+
+    IterativeSegmentTree(int size) : n(size), tree(2 * size, Monoid::identity()) {}
+
+    // Point update - O(log n)
+    void update(int idx, const T& val) {
+        idx += n;
+        tree[idx] = val;
+        for (idx /= 2; idx > 0; idx /= 2) tree[idx] = Monoid::combine(tree[2 * idx], tree[2 * idx + 1]);
+    }
+
+    // Combine of arr[l..r], inclusive like SegmentTree - O(log n)
+    T query(int l, int r) const {
+        T left = Monoid::identity(), right = Monoid::identity();
+        for (l += n, r += n + 1; l < r; l /= 2, r /= 2) {
+            if (l & 1) left = Monoid::combine(left, tree[l++]);
+            if (r & 1) right = Monoid::combine(tree[--r], right);
+        }
+        return Monoid::combine(left, right);
+    }
+
+    T get(int idx) const { return tree[idx + n]; }
+    int size() const { return n; }
+    size_t memoryBytes() const { return tree.size() * sizeof(T); }
+};
+
+// Affine maps x -> a*x + b (mod 1e9+7) under composition: a custom monoid
+// whose combine is not commutative. combine(f, g) applies f first, then g.
+struct Affine {
+    long long a = 1, b = 0;
+};
+
+struct AffineMonoid {
+    static const long long MOD = 1000000007;
+    static Affine identity() { return Affine(); }
+    static Affine combine(const Affine& f, const Affine& g) {
+        return {g.a * f.a % MOD, (g.a * f.b + g.b) % MOD};
+    }
+};
+
+template<typename F>
+double timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Benchmark: recursive SegmentTree / MinSegmentTree vs IterativeSegmentTree
+// on the same random mix of point updates and range queries
+struct SegmentOp {
+    bool update;
+    int i, j;  // update: index, value; query: l, r
+};
+
+// Runs the mix on one tree and prints a row; returns the sum of all answers
+template<typename Tree>
+long long benchmarkSegmentTree(const char* name, vector<int>& arr, const vector<SegmentOp>& mix) {
+    Tree* tree = nullptr;
+    long long checksum = 0;
+    double buildMs = timeMs([&] { tree = new Tree(arr); });
+    double opsMs = timeMs([&] {
+        for (const SegmentOp& op : mix) {
+            if (op.update) tree->update(op.i, op.j);
+            else checksum += tree->query(op.i, op.j);
+        }
+    });
+    printf("  %-20s %10.1f %12.1f %10.1f\n", name, buildMs, opsMs * 1e6 / mix.size(), tree->memoryBytes() / 1e6);
+    delete tree;
+    return checksum;
+}
+
+void benchmarkSegmentTrees(int n, int ops) {
+    vector<int> arr(n);
+    uint64_t x = 7;
+    auto next = [&] {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        return x;
+    };
+    for (int& v : arr) v = next() % 1000;
+    vector<SegmentOp> mix(ops);
+    for (SegmentOp& op : mix) {
+        op.update = next() % 2;
+        op.i = next() % n;
+        op.j = op.update ? next() % 1000 : op.i + next() % (n - op.i);
+    }
+
+    printf("  n = %d, %d ops (half point updates, half range queries)\n", n, ops);
+    printf("  %-20s %10s %12s %10s\n", "", "build ms", "ns per op", "memory MB");
+    long long sumRec = benchmarkSegmentTree<SegmentTree>("SegmentTree (sum)", arr, mix);
+    long long sumIter = benchmarkSegmentTree<IterativeSegmentTree<int, SumMonoid<int>>>("Iterative sum", arr, mix);
+    long long minRec = benchmarkSegmentTree<MinSegmentTree>("MinSegmentTree", arr, mix);
+    long long minIter = benchmarkSegmentTree<IterativeSegmentTree<int, MinMonoid<int>>>("Iterative min", arr, mix);
+    printf("  answers %s\n", sumRec == sumIter && minRec == minIter ? "match" : "DIFFER");
+}
+
 int main() {
     cout << "=== Segment Tree (Sum) ===\n";
     vector<int> arr = {1, 3, 5, 7, 9, 11};
@@ -186,5 +331,21 @@ int main() {
     cout << "Sum [0,5] after adding 3 to [2,4]: " << lst.query(0, 5) << endl;  // 39
     cout << "Sum [2,4]: " << lst.query(2, 4) << endl;  // 24
 
+    cout << "\n=== Iterative Segment Tree (Monoid) ===\n";
+    IterativeSegmentTree<int, SumMonoid<int>> sums(arr);  // arr is still {1, 3, 5, 7, 9, 11}
+    cout << "Sum [1,3]: " << sums.query(1, 3) << endl;  // 15
+    IterativeSegmentTree<int, MaxMonoid<int>> maxes(arr2);
+    cout << "Max [0,3]: " << maxes.query(0, 3) << endl;  // 5
+    IterativeSegmentTree<int, GcdMonoid<int>> gcds(vector<int>{12, 18, 24, 9});
+    cout << "GCD [0,2]: " << gcds.query(0, 2) << endl;  // 6
+    gcds.update(1, 8);
+    cout << "GCD [0,2] after arr[1]=8: " << gcds.query(0, 2) << endl;  // 4
+
+    // Custom monoid, order matters: (2x + 1) then (3x) gives 6x + 3
+    IterativeSegmentTree<Affine, AffineMonoid> maps(vector<Affine>{{2, 1}, {3, 0}, {1, 5}});
+    Affine f = maps.query(0, 1);
+    cout << "Composed [0,1]: " << f.a << "x + " << f.b << endl;  // 6x + 3
+    benchmarkSegmentTrees(1000000, 5000000);
+
     return 0;
 }
@@ -1,8 +1,80 @@
 #include <iostream>
 #include <unordered_map>
 #include <list>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
+// Heap counters for the benchmarks: every global operator new in this
+// program, plain or aligned, bumps heapAllocations, and heapBytes tracks live
+// bytes (a 16-byte header remembers each block's size for delete). Kept out
+// of line so the compiler pairs the malloc/free inside them, not with the
+// call sites.
+static atomic<long long> heapAllocations{0};
+static atomic<long long> heapBytes{0};
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    heapBytes.fetch_add(size, memory_order_relaxed);
+    char* p = (char*)malloc(size + 16);
+    if (!p) throw bad_alloc();
+    *(size_t*)p = size;
+    return p + 16;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = (char*)p - 16;
+    heapBytes.fetch_sub(*(size_t*)block, memory_order_relaxed);
+    free(block);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+// Over-aligned types (alignas(64) shards) use these. The header grows to the
+// alignment so the returned pointer stays aligned; the size sits just before it.
+static size_t alignedHeader(align_val_t align) { return max<size_t>(16, (size_t)align); }
+
+__attribute__((noinline)) void* operator new(size_t size, align_val_t align) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    heapBytes.fetch_add(size, memory_order_relaxed);
+    size_t header = alignedHeader(align);
+    size_t total = (size + header + (size_t)align - 1) / (size_t)align * (size_t)align;
+    char* p = (char*)aligned_alloc((size_t)align, total);
+    if (!p) throw bad_alloc();
+    *(size_t*)(p + header - sizeof(size_t)) = size;
+    return p + header;
+}
+
+__attribute__((noinline)) void operator delete(void* p, align_val_t align) noexcept {
+    if (!p) return;
+    heapBytes.fetch_sub(*(size_t*)((char*)p - sizeof(size_t)), memory_order_relaxed);
+    free((char*)p - alignedHeader(align));
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t, align_val_t align) noexcept {
+    operator delete(p, align);
+}
+
 // LRU Cache - O(1) for get and put
 class LRUCache {
 private:
@@ -29,6 +101,7 @@ public:
 
     // Put - O(1)
     void put(int key, int value) {
+        if (capacity <= 0) return;
         // If key exists, update and move to front
         if (map.find(key) != map.end()) {
             cache.erase(map[key]);
@@ -45,6 +118,8 @@ public:
         map[key] = cache.begin();
     }
 
+    int size() { return cache.size(); }
+
     void print() {
         cout << "Cache (MRU -> LRU): ";
         for (auto& p : cache) {
@@ -54,6 +129,214 @@ public:
     }
 };
 
+// Sharded LRU Cache - thread-safe
+// Keys are split by hash across N shards, each an independent LRUCache with
+// its own mutex, so threads touching different shards never contend. Each
+// shard evicts its own least recently used key; shard capacities add up to
+// the total capacity, so the cache never holds more than that.
+class ShardedLRUCache {
+private:
+    struct alignas(64) Shard {
+        mutex lock;
+        LRUCache cache;
+        int capacity;
+        Shard(int cap) : cache(cap), capacity(cap) {}
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    int totalCapacity;
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    Shard& shardFor(int key) { return *shards[mix((uint32_t)key) % shards.size()]; }
+
+public:
+    ShardedLRUCache(int cap, int shardCount = 16) : totalCapacity(max(cap, 0)) {
+        cap = totalCapacity;
+        shardCount = max(1, min(shardCount, cap));
+        for (int i = 0; i < shardCount; i++) {
+            // Spread the remainder so the shard capacities sum to cap
+            int shardCap = cap / shardCount + (i < cap % shardCount ? 1 : 0);
+            shards.push_back(make_unique<Shard>(shardCap));
+        }
+    }
+
+    // Get - O(1), locks one shard
+    int get(int key) {
+        Shard& s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        return s.cache.get(key);
+    }
+
+    // Put - O(1), locks one shard
+    void put(int key, int value) {
+        Shard& s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        s.cache.put(key, value);
+    }
+
+    // Entries across all shards
+    int size() {
+        int total = 0;
+        for (auto& s : shards) {
+            lock_guard<mutex> guard(s->lock);
+            total += s->cache.size();
+        }
+        return total;
+    }
+
+    int capacity() { return totalCapacity; }
+    int shardCount() { return shards.size(); }
+};
+
+// Node index for the slab-based caches: key -> 32-bit node number
+// Linear probing over {key, node} pairs in a power-of-two array at least
+// twice the entry count, with backward-shift deletion, so it never needs
+// tombstones and never allocates after construction.
+class NodeIndex {
+public:
+    static const uint32_t NONE = UINT32_MAX;
+
+    NodeIndex(int maxEntries) {
+        size_t size = 1;
+        while (size < 2 * (size_t)max(maxEntries, 1)) size <<= 1;
+        entries.assign(size, {0, NONE});
+        mask = size - 1;
+    }
+
+    // Node of key, or NONE
+    uint32_t find(int key) const { return entries[slotOf(key)].node; }
+
+    // Insert or overwrite
+    void insert(int key, uint32_t node) { entries[slotOf(key)] = {key, node}; }
+
+    void erase(int key) {
+        size_t hole = slotOf(key);
+        if (entries[hole].node == NONE) return;
+        // Pull later entries of the cluster back unless their home slot
+        // lies cyclically in (hole, j]
+        for (size_t j = (hole + 1) & mask; entries[j].node != NONE; j = (j + 1) & mask) {
+            size_t home = hash(entries[j].key) & mask;
+            bool homeInRange = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+            if (!homeInRange) {
+                entries[hole] = entries[j];
+                hole = j;
+            }
+        }
+        entries[hole].node = NONE;
+    }
+
+    size_t memoryBytes() const { return entries.size() * sizeof(Entry); }
+
+private:
+    struct Entry {
+        int key;
+        uint32_t node;  // NONE if the entry is empty
+    };
+
+    vector<Entry> entries;
+    size_t mask;
+
+    static size_t hash(int key) {
+        uint64_t x = (uint32_t)key * 0x9E3779B97F4A7C15ULL;
+        return x ^ (x >> 32);
+    }
+
+    // Slot holding key, or the empty slot where it would go
+    size_t slotOf(int key) const {
+        size_t i = hash(key) & mask;
+        while (entries[i].node != NONE && entries[i].key != key) i = (i + 1) & mask;
+        return i;
+    }
+};
+
+// Slab LRU Cache - allocation-free after construction
+// All capacity nodes live in one vector and link to each other by 32-bit
+// index (an intrusive circular list through a sentinel), and the key index
+// is a NodeIndex. get/put only relink indices, so steady-state operations
+// never touch the heap.
+class SlabLRUCache {
+private:
+    static const uint32_t NONE = NodeIndex::NONE;
+
+    struct Node {
+        int key;
+        int value;
+        uint32_t prev, next;
+    };
+
+    int capacity;
+    int count;
+    vector<Node> nodes;  // nodes[capacity] is the sentinel: next = MRU, prev = LRU
+    NodeIndex index;
+
+    uint32_t sentinel() const { return capacity; }
+
+    void unlink(uint32_t n) {
+        nodes[nodes[n].prev].next = nodes[n].next;
+        nodes[nodes[n].next].prev = nodes[n].prev;
+    }
+
+    void pushFront(uint32_t n) {
+        uint32_t head = nodes[sentinel()].next;
+        nodes[n].prev = sentinel();
+        nodes[n].next = head;
+        nodes[head].prev = n;
+        nodes[sentinel()].next = n;
+    }
+
+public:
+    SlabLRUCache(int cap) : capacity(max(cap, 1)), count(0), nodes(capacity + 1), index(capacity) {
+        nodes[sentinel()].prev = nodes[sentinel()].next = sentinel();
+    }
+
+    // Get - O(1), no allocation
+    int get(int key) {
+        uint32_t n = index.find(key);
+        if (n == NONE) return -1;
+        unlink(n);
+        pushFront(n);
+        return nodes[n].value;
+    }
+
+    // Put - O(1), no allocation; reuses the LRU node when full
+    void put(int key, int value) {
+        uint32_t n = index.find(key);
+        if (n != NONE) {
+            nodes[n].value = value;
+            unlink(n);
+            pushFront(n);
+            return;
+        }
+        if (count < capacity) {
+            n = count++;
+        } else {
+            n = nodes[sentinel()].prev;  // Evict LRU
+            unlink(n);
+            index.erase(nodes[n].key);
+        }
+        nodes[n].key = key;
+        nodes[n].value = value;
+        pushFront(n);
+        index.insert(key, n);
+    }
+
+    int size() { return count; }
+
+    void print() {
+        cout << "Cache (MRU -> LRU): ";
+        for (uint32_t n = nodes[sentinel()].next; n != sentinel(); n = nodes[n].next) {
+            cout << "[" << nodes[n].key << ":" << nodes[n].value << "] ";
+        }
+        cout << endl;
+    }
+};
+
 // LFU Cache - O(1) for get and put
 class LFUCache {
 private:
@@ -115,7 +398,861 @@ public:
     }
 };
 
-int main() {
+// CLOCK Cache (second chance) - approximate LRU
+// Entries sit in a fixed ring of slots with one reference bit each. A hit
+// only sets the bit; nothing is relinked. On a miss the hand sweeps the ring,
+// clearing set bits, and evicts the first entry whose bit was already clear.
+class ClockCache {
+private:
+    int capacity;
+    vector<int> keys;
+    vector<int> values;
+    vector<uint8_t> referenced;
+    unordered_map<int, int> map;  // key -> slot
+    int hand;
+
+public:
+    ClockCache(int cap) : capacity(cap), hand(0) {
+        keys.reserve(cap);
+        values.reserve(cap);
+        referenced.reserve(cap);
+    }
+
+    // Get - O(1), sets the reference bit only
+    int get(int key) {
+        auto it = map.find(key);
+        if (it == map.end()) return -1;
+        referenced[it->second] = 1;
+        return values[it->second];
+    }
+
+    // Put - O(1) amortized (the hand clears at most one bit per slot per sweep)
+    void put(int key, int value) {
+        if (capacity <= 0) return;
+        auto it = map.find(key);
+        if (it != map.end()) {
+            values[it->second] = value;
+            referenced[it->second] = 1;
+            return;
+        }
+        if ((int)keys.size() < capacity) {
+            map[key] = keys.size();
+            keys.push_back(key);
+            values.push_back(value);
+            referenced.push_back(0);
+            return;
+        }
+        while (referenced[hand]) {
+            referenced[hand] = 0;  // Second chance
+            hand = (hand + 1) % capacity;
+        }
+        map.erase(keys[hand]);
+        keys[hand] = key;
+        values[hand] = value;
+        map[key] = hand;
+        hand = (hand + 1) % capacity;
+    }
+
+    int size() { return keys.size(); }
+};
+
+// CLOCK-Pro Cache (Jiang, Chen, Zhang 2005)
+// Resident pages are hot or cold. A new page starts cold, in a "test
+// period"; if it is hit again before its test period ends it becomes hot.
+// Evicted cold pages in their test period stay on the clock as non-resident
+// metadata, and a miss on one of those means the cold area is too small.
+// Three hands sweep one circular list:
+//   handCold evicts cold pages (or promotes referenced ones under test)
+//   handHot  demotes unreferenced hot pages and ends test periods
+//   handTest ends test periods, dropping non-resident metadata
+// Like CLOCK, a hit only sets the reference bit.
+class ClockProCache {
+private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        int key;
+        int value;
+        bool hot, referenced, test, resident;
+        uint32_t prev, next;
+    };
+
+    int capacity;        // Resident pages
+    int coldTarget;      // Adaptive share of capacity for cold pages
+    int hotCount, coldCount, nonResidentCount;
+    vector<Node> nodes;  // Resident + non-resident, at most 2 * capacity
+    vector<uint32_t> freeNodes;
+    unordered_map<int, uint32_t> map;  // key -> node
+    uint32_t handHot, handCold, handTest;
+
+    void advance(uint32_t& hand) { hand = nodes[hand].next; }
+
+    void unlink(uint32_t n) {
+        for (uint32_t* hand : {&handHot, &handCold, &handTest}) {
+            if (*hand == n) *hand = nodes[n].next == n ? NONE : nodes[n].next;
+        }
+        nodes[nodes[n].prev].next = nodes[n].next;
+        nodes[nodes[n].next].prev = nodes[n].prev;
+    }
+
+    // List head: just behind handHot, the last place it will reach
+    void linkAtHead(uint32_t n) {
+        if (handHot == NONE) {
+            nodes[n].prev = nodes[n].next = n;
+            handHot = handCold = handTest = n;
+            return;
+        }
+        uint32_t tail = nodes[handHot].prev;
+        nodes[n].prev = tail;
+        nodes[n].next = handHot;
+        nodes[tail].next = n;
+        nodes[handHot].prev = n;
+    }
+
+    void removeNode(uint32_t n) {
+        unlink(n);
+        map.erase(nodes[n].key);
+        freeNodes.push_back(n);
+    }
+
+    void adjustColdTarget(int delta) {
+        coldTarget = max(1, min(capacity - 1, coldTarget + delta));
+    }
+
+    void runHandHot() {
+        while (hotCount > 0) {
+            uint32_t n = handHot;
+            Node& node = nodes[n];
+            if (node.hot) {
+                advance(handHot);
+                if (node.referenced) {
+                    node.referenced = false;
+                } else {
+                    node.hot = false;  // Demote
+                    hotCount--;
+                    coldCount++;
+                    return;
+                }
+            } else if (node.test) {
+                node.test = false;  // Test period over without a re-access
+                adjustColdTarget(-1);
+                if (!node.resident) {
+                    nonResidentCount--;
+                    removeNode(n);
+                    continue;
+                }
+                advance(handHot);
+            } else {
+                advance(handHot);
+            }
+        }
+    }
+
+    void runHandTest() {
+        for (;;) {
+            uint32_t n = handTest;
+            Node& node = nodes[n];
+            if (!node.hot && node.test) {
+                node.test = false;
+                adjustColdTarget(-1);
+                if (!node.resident) {
+                    nonResidentCount--;
+                    removeNode(n);
+                    return;
+                }
+            }
+            advance(handTest);
+        }
+    }
+
+    // Free one resident slot by evicting a cold page
+    void runHandCold() {
+        for (;;) {
+            uint32_t n = handCold;
+            Node& node = nodes[n];
+            if (!node.resident || node.hot) {
+                advance(handCold);
+                continue;
+            }
+            if (node.referenced) {
+                node.referenced = false;
+                unlink(n);
+                if (node.test) {
+                    node.hot = true;  // Re-accessed during its test period
+                    node.test = false;
+                    coldCount--;
+                    hotCount++;
+                } else {
+                    node.test = true;  // Start a new test period
+                }
+                linkAtHead(n);
+                while (hotCount > capacity - coldTarget) runHandHot();
+                continue;
+            }
+            advance(handCold);
+            node.resident = false;
+            coldCount--;
+            if (node.test) {
+                nonResidentCount++;  // Keep the key to detect a quick return
+                while (nonResidentCount > capacity) runHandTest();
+            } else {
+                removeNode(n);
+            }
+            return;
+        }
+    }
+
+public:
+    ClockProCache(int cap)
+        : capacity(cap), coldTarget(max(1, cap / 2)), hotCount(0), coldCount(0),
+          nonResidentCount(0), handHot(NONE), handCold(NONE), handTest(NONE) {
+        nodes.resize(2 * max(cap, 0) + 1);
+        for (int i = nodes.size() - 1; i >= 0; i--) freeNodes.push_back(i);
+    }
+
+    // Get - O(1), sets the reference bit only
+    int get(int key) {
+        auto it = map.find(key);
+        if (it == map.end() || !nodes[it->second].resident) return -1;
+        nodes[it->second].referenced = true;
+        return nodes[it->second].value;
+    }
+
+    // Put - O(1) amortized
+    void put(int key, int value) {
+        if (capacity <= 0) return;
+        auto it = map.find(key);
+        if (it != map.end() && nodes[it->second].resident) {
+            nodes[it->second].value = value;
+            nodes[it->second].referenced = true;
+            return;
+        }
+
+        while (hotCount + coldCount >= capacity) runHandCold();
+
+        it = map.find(key);  // The hands may have dropped its metadata
+        if (it != map.end()) {
+            // Miss on a non-resident page still under test: the cold area
+            // is too small, and the page comes back hot
+            uint32_t n = it->second;
+            adjustColdTarget(+1);
+            unlink(n);
+            nonResidentCount--;
+            nodes[n] = {key, value, true, false, false, true, 0, 0};
+            linkAtHead(n);
+            hotCount++;
+            while (hotCount > capacity - coldTarget) runHandHot();
+            return;
+        }
+
+        uint32_t n = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[n] = {key, value, false, false, true, true, 0, 0};
+        linkAtHead(n);
+        map[key] = n;
+        coldCount++;
+    }
+
+    int size() { return hotCount + coldCount; }
+};
+
+// Count-Min Sketch with 4-bit counters (frequency estimates for TinyLFU)
+// depth rows of width counters, 16 counters per 64-bit word. A key bumps one
+// counter per row and its estimate is the row minimum, so collisions only
+// overestimate. After sampleSize increments every counter is halved, which
+// ages out old popularity.
+class CountMinSketch {
+private:
+    static const int DEPTH = 4;
+    vector<uint64_t> table;
+    size_t widthMask;
+    int additions;
+    int sampleSize;
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Counter number in row r (double hashing)
+    size_t counterIndex(uint64_t h, int r) const {
+        uint32_t h1 = (uint32_t)h, h2 = (uint32_t)(h >> 32) | 1;
+        return r * (widthMask + 1) + ((h1 + r * h2) & widthMask);
+    }
+
+    int counter(size_t i) const { return (table[i / 16] >> (i % 16 * 4)) & 15; }
+
+public:
+    CountMinSketch(int capacity) : additions(0), sampleSize(10 * max(capacity, 1)) {
+        size_t width = 16;
+        while (width < (size_t)capacity) width <<= 1;
+        widthMask = width - 1;
+        table.assign(DEPTH * width / 16, 0);
+    }
+
+    void increment(int key) {
+        uint64_t h = mix((uint32_t)key);
+        bool added = false;
+        for (int r = 0; r < DEPTH; r++) {
+            size_t i = counterIndex(h, r);
+            if (counter(i) < 15) {
+                table[i / 16] += 1ULL << (i % 16 * 4);
+                added = true;
+            }
+        }
+        if (added && ++additions >= sampleSize) reset();
+    }
+
+    int estimate(int key) const {
+        uint64_t h = mix((uint32_t)key);
+        int freq = 15;
+        for (int r = 0; r < DEPTH; r++) freq = min(freq, counter(counterIndex(h, r)));
+        return freq;
+    }
+
+    // Halve every counter (shift each nibble right by one)
+    void reset() {
+        for (uint64_t& word : table) word = (word >> 1) & 0x7777777777777777ULL;
+        additions /= 2;
+    }
+
+    size_t memoryBytes() const { return table.size() * sizeof(uint64_t); }
+};
+
+// W-TinyLFU Cache (Einziger, Friedman, Manes 2017)
+// New keys enter a small LRU window (1% of capacity). A key leaving the
+// window competes with the main cache's eviction victim and is admitted
+// only if the sketch says it is more frequent. The main cache is segmented
+// LRU: probation (20%) for admitted keys, protected (80%) for keys hit again
+// while in probation. Nodes live in one slab and link by 32-bit index, so
+// the per-entry cost is a 20-byte node, 16-32 bytes of index (8-byte slots,
+// 2-4 per entry) and 2-4 bytes of sketch (4 rows of 4-bit counters, each row
+// as wide as capacity rounded up to a power of two).
+class TinyLFUCache {
+private:
+    static const uint32_t NONE = NodeIndex::NONE;
+    enum Segment : uint8_t { WINDOW, PROBATION, PROTECTED };
+
+    struct Node {
+        int key;
+        int value;
+        uint32_t prev, next;
+        Segment segment;
+    };
+
+    int capacity;
+    int windowCap, protectedCap, mainCap;
+    int sizes[3];
+    vector<Node> nodes;  // capacity + 1 data nodes, then one sentinel per segment
+    vector<uint32_t> freeNodes;
+    NodeIndex index;
+    CountMinSketch sketch;
+
+    uint32_t sentinel(Segment seg) const { return capacity + 1 + seg; }
+    uint32_t lru(Segment seg) const { return nodes[sentinel(seg)].prev; }
+
+    void unlink(uint32_t n) {
+        nodes[nodes[n].prev].next = nodes[n].next;
+        nodes[nodes[n].next].prev = nodes[n].prev;
+        sizes[nodes[n].segment]--;
+    }
+
+    void pushFront(uint32_t n, Segment seg) {
+        uint32_t s = sentinel(seg), head = nodes[s].next;
+        nodes[n].prev = s;
+        nodes[n].next = head;
+        nodes[head].prev = n;
+        nodes[s].next = n;
+        nodes[n].segment = seg;
+        sizes[seg]++;
+    }
+
+    void evict(uint32_t n) {
+        unlink(n);
+        index.erase(nodes[n].key);
+        freeNodes.push_back(n);
+    }
+
+    void onHit(uint32_t n) {
+        Segment seg = nodes[n].segment;
+        unlink(n);
+        if (seg == WINDOW) {
+            pushFront(n, WINDOW);
+            return;
+        }
+        pushFront(n, PROTECTED);  // Probation hit promotes
+        if (sizes[PROTECTED] > protectedCap) {
+            uint32_t demoted = lru(PROTECTED);
+            unlink(demoted);
+            pushFront(demoted, PROBATION);
+        }
+    }
+
+    // A key falling out of the window: admit it to main if main has room or
+    // it is estimated more frequent than main's victim
+    void admit(uint32_t candidate) {
+        if (sizes[PROBATION] + sizes[PROTECTED] < mainCap) {
+            pushFront(candidate, PROBATION);
+            return;
+        }
+        if (mainCap == 0) {
+            freeNodes.push_back(candidate);
+            index.erase(nodes[candidate].key);
+            return;
+        }
+        uint32_t victim = sizes[PROBATION] > 0 ? lru(PROBATION) : lru(PROTECTED);
+        if (sketch.estimate(nodes[candidate].key) > sketch.estimate(nodes[victim].key)) {
+            evict(victim);
+            pushFront(candidate, PROBATION);
+        } else {
+            freeNodes.push_back(candidate);
+            index.erase(nodes[candidate].key);
+        }
+    }
+
+public:
+    TinyLFUCache(int cap) : capacity(max(cap, 1)), sizes{0, 0, 0}, index(capacity + 1), sketch(capacity) {
+        windowCap = max(1, capacity / 100);
+        mainCap = capacity - windowCap;
+        protectedCap = mainCap * 4 / 5;
+        nodes.resize(capacity + 4);
+        for (int seg = WINDOW; seg <= PROTECTED; seg++) {
+            uint32_t s = sentinel((Segment)seg);
+            nodes[s].prev = nodes[s].next = s;
+        }
+        for (int i = capacity; i >= 0; i--) freeNodes.push_back(i);
+    }
+
+    // Get - O(1); a hit also counts toward the key's frequency
+    int get(int key) {
+        uint32_t n = index.find(key);
+        if (n == NONE) return -1;
+        sketch.increment(key);
+        onHit(n);
+        return nodes[n].value;
+    }
+
+    // Put - O(1); a new key counts toward its frequency even if the window
+    // later rejects it, so a key that keeps coming back wins admission
+    void put(int key, int value) {
+        uint32_t n = index.find(key);
+        if (n != NONE) {
+            nodes[n].value = value;
+            onHit(n);
+            return;
+        }
+        sketch.increment(key);
+        n = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[n].key = key;
+        nodes[n].value = value;
+        pushFront(n, WINDOW);
+        index.insert(key, n);
+        if (sizes[WINDOW] > windowCap) {
+            uint32_t candidate = lru(WINDOW);
+            unlink(candidate);
+            admit(candidate);
+        }
+    }
+
+    int size() { return sizes[WINDOW] + sizes[PROBATION] + sizes[PROTECTED]; }
+};
+
+// Benchmark: get/put throughput, one global mutex vs shards
+// 80% gets / 20% puts over a key range twice the capacity
+template<typename Get, typename Put>
+double cacheThroughput(int threads, int totalOps, int keyRange, Get get, Put put) {
+    vector<thread> workers;
+    int opsPerThread = totalOps / threads;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([=] {
+            uint64_t x = 0x9E3779B97F4A7C15ULL * (t + 1);
+            for (int i = 0; i < opsPerThread; i++) {
+                x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                int key = x % keyRange;
+                if (x % 5 == 0) put(key, i);
+                else get(key);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return (double)opsPerThread * threads / sec / 1e6;
+}
+
+void benchmarkShardedLRU(int capacity, int totalOps) {
+    LRUCache global(capacity);
+    mutex globalLock;
+    ShardedLRUCache sharded(capacity, 64);
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double g = cacheThroughput(threads, totalOps, 2 * capacity,
+            [&](int k) { lock_guard<mutex> l(globalLock); return global.get(k); },
+            [&](int k, int v) { lock_guard<mutex> l(globalLock); global.put(k, v); });
+        double s = cacheThroughput(threads, totalOps, 2 * capacity,
+            [&](int k) { return sharded.get(k); },
+            [&](int k, int v) { sharded.put(k, v); });
+        printf("  %2d threads: global mutex %6.2f Mops/s, sharded %6.2f Mops/s\n", threads, g, s);
+    }
+    cout << "  Sharded size " << sharded.size() << " / capacity " << sharded.capacity() << endl;
+}
+
+// Benchmark: heap allocations and time per operation, single thread
+template<typename Cache>
+void reportAllocations(const string& name, Cache& cache, int keyRange, int ops) {
+    uint64_t x = 0x2545F4914F6CDD1DULL;
+    auto run = [&](int n) {
+        for (int i = 0; i < n; i++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            int key = x % keyRange;
+            if (x % 5 == 0 || cache.get(key) == -1) cache.put(key, i);
+        }
+    };
+    run(ops);  // Warm up to steady state (cache full)
+    long long before = heapAllocations.load();
+    auto start = chrono::steady_clock::now();
+    run(ops);
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+    double allocs = (double)(heapAllocations.load() - before) / ops;
+    printf("  %-8s %6.3f allocations/op, %6.1f ns/op\n", name.c_str(), allocs, ns);
+}
+
+void benchmarkSlabLRU(int capacity, int ops) {
+    LRUCache lru(capacity);
+    SlabLRUCache slab(capacity);
+    reportAllocations("LRU", lru, 2 * capacity, ops);
+    reportAllocations("Slab", slab, 2 * capacity, ops);
+}
+
+// Trace generators
+// Zipf(alpha) over keys [0, n): key k has probability ~ 1 / (k + 1)^alpha
+vector<int> zipfTrace(int length, int n, double alpha, uint64_t seed) {
+    vector<double> cdf(n);
+    double sum = 0;
+    for (int k = 0; k < n; k++) cdf[k] = (sum += 1.0 / pow(k + 1.0, alpha));
+    vector<int> trace(length);
+    uint64_t x = seed | 1;
+    for (int i = 0; i < length; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        double u = (x >> 11) * (1.0 / 9007199254740992.0) * sum;
+        trace[i] = lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+    }
+    return trace;
+}
+
+// Zipf traffic interrupted by one-time sequential scans of fresh keys
+vector<int> scanTrace(int length, int n, int scanLength, int scanEvery, uint64_t seed) {
+    vector<int> zipf = zipfTrace(length, n, 0.9, seed);
+    vector<int> trace;
+    int nextScanKey = n;
+    for (int i = 0; i < length; i++) {
+        trace.push_back(zipf[i]);
+        if (i % scanEvery == scanEvery - 1) {
+            for (int j = 0; j < scanLength; j++) trace.push_back(nextScanKey++);
+        }
+    }
+    return trace;
+}
+
+// Repeated sequential loop over n keys
+vector<int> loopTrace(int length, int n) {
+    vector<int> trace(length);
+    for (int i = 0; i < length; i++) trace[i] = i % n;
+    return trace;
+}
+
+// Key trace: an in-memory vector or a memory-mapped file
+// Binary files are little-endian uint64 keys, folded to int (k ^ k >> 32).
+// Text files hold one integer key per line; only the first token counts and
+// lines not starting with a number (headers, comments) or holding one longer
+// than 18 digits are skipped. Mapped files are parsed on the fly, so replaying
+// never copies the trace.
+class KeyTrace {
+private:
+    const vector<int>* keys = nullptr;
+    const char* data = nullptr;
+    size_t bytes = 0;
+    bool binary = false;
+    size_t count = 0;
+
+public:
+    KeyTrace(const vector<int>& k) : keys(&k), count(k.size()) {}
+
+    KeyTrace(const string& path, bool binaryFormat) : binary(binaryFormat) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data = (const char*)p;
+                bytes = st.st_size;
+                madvise(p, bytes, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+        if (data) forEach([this](int) { count++; });
+    }
+
+    ~KeyTrace() {
+        if (data) munmap((void*)data, bytes);
+    }
+
+    KeyTrace(const KeyTrace&) = delete;
+    KeyTrace& operator=(const KeyTrace&) = delete;
+
+    bool isOpen() const { return keys || data; }
+    size_t size() const { return count; }
+
+    template<typename F>
+    void forEach(F f) const {
+        if (keys) {
+            for (int k : *keys) f(k);
+        } else if (binary) {
+            for (size_t i = 0; i + 8 <= bytes; i += 8) {
+                uint64_t k;
+                memcpy(&k, data + i, 8);
+                f((int)(uint32_t)(k ^ (k >> 32)));
+            }
+        } else {
+            const char* p = data;
+            const char* end = data + bytes;
+            while (p < end) {
+                while (p < end && (*p == ' ' || *p == '\t')) p++;
+                bool negative = p < end && *p == '-';
+                if (negative) p++;
+                if (p < end && *p >= '0' && *p <= '9') {
+                    // At most 18 digits, which always fit in long long
+                    const char* digits = p;
+                    long long k = 0;
+                    while (p < end && *p >= '0' && *p <= '9' && p - digits < 18) k = k * 10 + (*p++ - '0');
+                    bool tooLong = p < end && *p >= '0' && *p <= '9';
+                    if (!tooLong) f((int)(negative ? -k : k));
+                }
+                while (p < end && *p != '\n') p++;
+                if (p < end) p++;
+            }
+        }
+    }
+};
+
+// Write a trace in the format KeyTrace reads
+bool writeTrace(const string& path, const vector<int>& trace, bool binary) {
+    FILE* f = fopen(path.c_str(), binary ? "wb" : "w");
+    if (!f) return false;
+    for (int k : trace) {
+        if (binary) {
+            uint64_t key = (uint32_t)k;
+            fwrite(&key, 8, 1, f);
+        } else {
+            fprintf(f, "%d\n", k);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+struct ReplayStats {
+    long long accesses = 0;
+    long long hits = 0;
+    double seconds = 0;
+    long long bytes = 0;           // Live heap bytes held by the cache at the end
+    double p50 = 0, p99 = 0, p999 = 0;  // Per-access latency, ns
+};
+
+// Replay a trace through a fresh cache; a miss inserts the key. Every 16th
+// access is timed individually for the latency percentiles.
+template<typename Cache>
+ReplayStats replay(int capacity, const KeyTrace& trace) {
+    ReplayStats stats;
+    vector<float> samples;
+    samples.reserve(trace.size() / 16 + 1);
+    long long before = heapBytes.load();
+    Cache cache(capacity);
+    auto access = [&](int key) {
+        if (cache.get(key) != -1) stats.hits++;
+        else cache.put(key, 1);
+    };
+    auto start = chrono::steady_clock::now();
+    trace.forEach([&](int key) {
+        if (stats.accesses++ % 16 == 0) {
+            auto t0 = chrono::steady_clock::now();
+            access(key);
+            samples.push_back(chrono::duration<float, nano>(chrono::steady_clock::now() - t0).count());
+        } else {
+            access(key);
+        }
+    });
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.bytes = heapBytes.load() - before;
+    if (!samples.empty()) {
+        sort(samples.begin(), samples.end());
+        auto pct = [&](double q) { return samples[min(samples.size() - 1, (size_t)(q * samples.size()))]; };
+        stats.p50 = pct(0.50);
+        stats.p99 = pct(0.99);
+        stats.p999 = pct(0.999);
+    }
+    return stats;
+}
+
+const vector<string> POLICIES = {"lru", "slab", "sharded", "lfu", "clock", "clockpro", "tinylfu"};
+
+// Replay the trace through the named policy; false if the name is not in POLICIES
+bool replayPolicy(const string& policy, int capacity, const KeyTrace& trace, ReplayStats& out) {
+    if (policy == "lru") out = replay<LRUCache>(capacity, trace);
+    else if (policy == "slab") out = replay<SlabLRUCache>(capacity, trace);
+    else if (policy == "sharded") out = replay<ShardedLRUCache>(capacity, trace);
+    else if (policy == "lfu") out = replay<LFUCache>(capacity, trace);
+    else if (policy == "clock") out = replay<ClockCache>(capacity, trace);
+    else if (policy == "clockpro") out = replay<ClockProCache>(capacity, trace);
+    else if (policy == "tinylfu") out = replay<TinyLFUCache>(capacity, trace);
+    else return false;
+    return true;
+}
+
+void printReplay(const string& policy, const ReplayStats& s) {
+    printf("    %-9s hit %6.2f%%  %6.2f Mops/s  %7.2f MB  p50 %5.0fns p99 %6.0fns p999 %7.0fns\n",
+           policy.c_str(), 100.0 * s.hits / max(1LL, s.accesses), s.accesses / s.seconds / 1e6,
+           s.bytes / 1e6, s.p50, s.p99, s.p999);
+}
+
+void benchmarkPolicies(int capacity, int length) {
+    vector<pair<string, vector<int>>> traces = {
+        {"zipf 0.99", zipfTrace(length, 100 * capacity, 0.99, 1)},
+        {"zipf 0.7", zipfTrace(length, 100 * capacity, 0.7, 2)},
+        {"zipf + scans", scanTrace(length, 100 * capacity, 2 * capacity, length / 20, 3)},
+        {"loop 1.2x capacity", loopTrace(length, capacity + capacity / 5)},
+    };
+    for (auto& t : traces) {
+        cout << "  " << t.first << " (" << t.second.size() << " accesses, capacity " << capacity << "):\n";
+        KeyTrace trace(t.second);
+        for (const char* policy : {"lru", "lfu", "clock", "clockpro", "tinylfu"}) {
+            ReplayStats stats;
+            if (replayPolicy(policy, capacity, trace, stats)) printReplay(policy, stats);
+        }
+    }
+}
+
+// Command line: trace generation and replay
+//   17_lru_cache generate zipf|scan|loop <out> [--length N] [--keys N]
+//                [--alpha A] [--binary]
+//   17_lru_cache replay <trace> [--capacity N] [--policy NAME|all] [--binary]
+int runTraceTool(int argc, char** argv) {
+    string command = argv[1];
+    map<string, string> options;
+    vector<string> args;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--binary") options[arg] = "1";
+        else if (arg.rfind("--", 0) == 0 && i + 1 < argc) options[arg] = argv[++i];
+        else args.push_back(arg);
+    }
+    auto option = [&](const string& name, const string& fallback) {
+        return options.count(name) ? options[name] : fallback;
+    };
+    bool binary = options.count("--binary");
+    auto usage = [&] {
+        cerr << "usage: " << argv[0] << " generate zipf|scan|loop <out> [--length N] [--keys N] [--alpha A] [--binary]\n"
+             << "       " << argv[0] << " replay <trace> [--capacity N] [--policy NAME|all] [--binary]\n"
+             << "       NAME is one of:";
+        for (const string& p : POLICIES) cerr << " " << p;
+        cerr << "\n";
+        return 1;
+    };
+    // Positive integer option; false (with a message) if malformed or <= 0
+    auto positiveOption = [&](const string& name, const string& fallback, int& out) {
+        string text = option(name, fallback);
+        char* end;
+        errno = 0;
+        long value = strtol(text.c_str(), &end, 10);
+        if (end == text.c_str() || *end || errno || value <= 0 || value > INT_MAX) {
+            cerr << name << " must be a positive integer, got '" << text << "'\n";
+            return false;
+        }
+        out = (int)value;
+        return true;
+    };
+
+    if (command == "generate" && args.size() == 2) {
+        int length, keys;
+        if (!positiveOption("--length", "10000000", length) || !positiveOption("--keys", "1000000", keys)) {
+            return usage();
+        }
+        string alphaText = option("--alpha", "0.99");
+        char* alphaEnd;
+        double alpha = strtod(alphaText.c_str(), &alphaEnd);
+        if (alphaEnd == alphaText.c_str() || *alphaEnd || !(alpha >= 0)) {
+            cerr << "--alpha must be a non-negative number, got '" << alphaText << "'\n";
+            return usage();
+        }
+        vector<int> trace;
+        if (args[0] == "zipf") trace = zipfTrace(length, keys, alpha, 1);
+        else if (args[0] == "scan") trace = scanTrace(length, keys, keys / 50, length / 20, 1);
+        else if (args[0] == "loop") trace = loopTrace(length, keys);
+        else {
+            cerr << "unknown generator: " << args[0] << endl;
+            return 1;
+        }
+        if (!writeTrace(args[1], trace, binary)) {
+            cerr << "cannot write " << args[1] << endl;
+            return 1;
+        }
+        cout << "Wrote " << trace.size() << " keys to " << args[1] << endl;
+        return 0;
+    }
+
+    if (command == "replay" && args.size() == 1) {
+        KeyTrace trace(args[0], binary);
+        if (!trace.isOpen()) {
+            cerr << "cannot map " << args[0] << endl;
+            return 1;
+        }
+        int capacity;
+        if (!positiveOption("--capacity", "100000", capacity)) return usage();
+        string policy = option("--policy", "all");
+        if (policy != "all" && find(POLICIES.begin(), POLICIES.end(), policy) == POLICIES.end()) {
+            cerr << "unknown policy: " << policy << endl;
+            return usage();
+        }
+        cout << args[0] << ": " << trace.size() << " accesses, capacity " << capacity << endl;
+        for (const string& p : POLICIES) {
+            ReplayStats stats;
+            if ((policy == "all" || policy == p) && replayPolicy(p, capacity, trace, stats)) printReplay(p, stats);
+        }
+        return 0;
+    }
+
+    return usage();
+}
+
+// Benchmark: live heap bytes per entry once the cache is full
+template<typename Cache>
+void reportMemory(const string& name, int capacity) {
+    long long before = heapBytes.load();
+    {
+        Cache cache(capacity);
+        for (int k = 0; k < capacity; k++) cache.put(k * 7919, k);
+        printf("  %-9s %6.1f bytes/entry\n", name.c_str(), (double)(heapBytes.load() - before) / capacity);
+    }
+}
+
+void benchmarkMemory(int capacity) {
+    reportMemory<LRUCache>("LRU", capacity);
+    reportMemory<LFUCache>("LFU", capacity);
+    reportMemory<ClockCache>("CLOCK", capacity);
+    reportMemory<ClockProCache>("CLOCK-Pro", capacity);
+    reportMemory<SlabLRUCache>("Slab LRU", capacity);
+    reportMemory<ShardedLRUCache>("Sharded", capacity);
+    reportMemory<TinyLFUCache>("W-TinyLFU", capacity);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) return runTraceTool(argc, argv);
+
     cout << "=== LRU Cache ===\n";
     LRUCache lru(3);
 
@@ -135,6 +1272,16 @@ int main() {
     lru.put(1, 150);  // Update existing
     lru.print();  // [1:150] [4:400] [3:300]
 
+    cout << "\n=== Slab LRU Cache ===\n";
+    SlabLRUCache slab(3);
+    slab.put(1, 100);
+    slab.put(2, 200);
+    slab.put(3, 300);
+    cout << "Get 1: " << slab.get(1) << endl;  // 100
+    slab.put(4, 400);  // Evicts key 2, reusing its node
+    slab.print();  // [4:400] [1:100] [3:300]
+    cout << "Get 2: " << slab.get(2) << endl;  // -1 (evicted)
+
     cout << "\n=== LFU Cache ===\n";
     LFUCache lfu(2);
 
@@ -151,5 +1298,66 @@ int main() {
     cout << "Get 3: " << lfu.get(3) << endl;  // -1 (evicted)
     cout << "Get 4: " << lfu.get(4) << endl;  // 40
 
+    cout << "\n=== CLOCK Cache ===\n";
+    ClockCache clock(3);
+    clock.put(1, 100);
+    clock.put(2, 200);
+    clock.put(3, 300);
+    clock.get(1);  // Sets 1's reference bit
+    clock.put(4, 400);  // Hand clears 1's bit, evicts 2
+    cout << "Get 1: " << clock.get(1) << endl;  // 100
+    cout << "Get 2: " << clock.get(2) << endl;  // -1 (evicted)
+
+    cout << "\n=== CLOCK-Pro Cache ===\n";
+    ClockProCache clockPro(3);
+    clockPro.put(1, 100);
+    clockPro.put(2, 200);
+    clockPro.put(3, 300);
+    clockPro.get(1);
+    clockPro.put(4, 400);  // Evicts a cold unreferenced page
+    cout << "Get 1: " << clockPro.get(1) << endl;  // 100
+    cout << "Size: " << clockPro.size() << endl;  // 3
+
+    cout << "\n=== W-TinyLFU Cache ===\n";
+    TinyLFUCache tiny(100);
+    for (int round = 0; round < 5; round++) {
+        for (int k = 0; k < 50; k++) {
+            if (tiny.get(k) == -1) tiny.put(k, k);  // Popular keys 0..49
+        }
+    }
+    for (int k = 1000; k < 2000; k++) {
+        if (tiny.get(k) == -1) tiny.put(k, k);  // One-off scan
+    }
+    int kept = 0;
+    for (int k = 0; k < 50; k++) kept += tiny.get(k) != -1;
+    cout << "Popular keys kept after scan: " << kept << " / 50" << endl;
+
+    cout << "\n=== Sharded LRU Cache ===\n";
+    ShardedLRUCache slru(100, 8);
+    vector<thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&slru, t] {
+            for (int i = t; i < 1000; i += 4) slru.put(i, i * 10);
+        });
+    }
+    for (auto& w : writers) w.join();
+    cout << "Size: " << slru.size() << " / " << slru.capacity()
+         << " across " << slru.shardCount() << " shards" << endl;  // 100 / 100
+    slru.put(5000, 1);
+    cout << "Get 5000: " << slru.get(5000) << endl;  // 1
+    cout << "Get 0: " << slru.get(0) << endl;  // -1 (evicted)
+
+    cout << "\n=== Benchmark: Sharded LRU Throughput ===\n";
+    benchmarkShardedLRU(1 << 16, 2000000);
+
+    cout << "\n=== Benchmark: Allocations per Operation ===\n";
+    benchmarkSlabLRU(1 << 16, 2000000);
+
+    cout << "\n=== Benchmark: Eviction Policies ===\n";
+    benchmarkPolicies(1000, 1000000);
+
+    cout << "\n=== Benchmark: Memory per Entry (100000 entries) ===\n";
+    benchmarkMemory(100000);
+
     return 0;
 }